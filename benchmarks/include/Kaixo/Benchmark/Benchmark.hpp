@@ -0,0 +1,55 @@
+
+// ------------------------------------------------
+
+#pragma once
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/pch.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Definitions.hpp"
+#include "Kaixo/Core/Controller.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    constexpr double SampleRate = 48000;
+    constexpr std::size_t MaxBlockSize = 2048;
+
+    // ------------------------------------------------
+
+    // Controller shared by all benchmarks, prepared with the settings above.
+    Controller& controller();
+
+    // Attach a standalone module to the shared controller, and prepare it.
+    template<std::derived_from<Processing::Module> Ty>
+    Ty& prepare(Ty& module) {
+        controller().attach(module);
+        module.prepare(SampleRate, MaxBlockSize);
+        module.reset();
+        return module;
+    }
+
+    // ------------------------------------------------
+
+    // Same white noise in [-1, 1] every run, so results are comparable.
+    std::vector<float> noise(std::size_t samples);
+    std::vector<Processing::Stereo> stereoNoise(std::size_t samples);
+
+    // ------------------------------------------------
+
+    // Block sizes used by the benchmarks that process blocks.
+    inline void blockSizes(::benchmark::internal::Benchmark* benchmark) {
+        benchmark->RangeMultiplier(4)->Range(32, MaxBlockSize);
+    }
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
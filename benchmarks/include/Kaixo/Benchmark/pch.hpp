@@ -0,0 +1,20 @@
+
+// ------------------------------------------------
+
+#ifdef __cplusplus 
+// ^^ Same as the test PCH, exclude the contents when this
+//    somehow gets compiled as C.
+
+// ------------------------------------------------
+
+#pragma once
+
+// ------------------------------------------------
+
+#include "benchmark/benchmark.h"
+
+// ------------------------------------------------
+
+#endif
+
+// ------------------------------------------------
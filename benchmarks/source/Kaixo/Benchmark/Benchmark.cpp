@@ -0,0 +1,46 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    Controller& controller() {
+        static std::unique_ptr<Controller> controller = [] {
+            std::unique_ptr<Controller> result{ createController() };
+            result->setNonRealtime(true);
+            result->prepareToPlay(SampleRate, MaxBlockSize);
+            return result;
+        }();
+
+        return *controller;
+    }
+
+    // ------------------------------------------------
+
+    std::vector<float> noise(std::size_t samples) {
+        std::mt19937 engine{ 0 };
+        std::uniform_real_distribution<float> distribution{ -1.f, 1.f };
+        std::vector<float> result(samples);
+        for (auto& sample : result) sample = distribution(engine);
+        return result;
+    }
+
+    std::vector<Processing::Stereo> stereoNoise(std::size_t samples) {
+        auto values = noise(2 * samples);
+        std::vector<Processing::Stereo> result(samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            result[i] = { values[2 * i], values[2 * i + 1] };
+        }
+        return result;
+    }
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,44 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/DelayBuffer.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    void DelayBufferProcessBlock(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = stereoNoise(samples);
+        std::vector<Stereo> output(samples);
+
+        DelayBuffer delay{ 1000 };
+        prepare(delay);
+        delay.delay(250);
+
+        for (auto _ : state) {
+            delay.processBlock(input, output);
+            ::benchmark::DoNotOptimize(output.data());
+            ::benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    BENCHMARK(DelayBufferProcessBlock)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
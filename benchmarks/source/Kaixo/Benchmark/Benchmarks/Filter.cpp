@@ -0,0 +1,177 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Filter.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Every parallel filter is processed with the same input, so items are
+    // samples times the amount of parallel filters.
+    template<std::size_t Parallel>
+    void BiquadProcessBatch(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = noise(samples);
+
+        Biquad<Math, Parallel> filter;
+        filter.sampleRate(SampleRate);
+        filter.type(FilterType::LowPass);
+        filter.frequency(2000);
+        filter.resonance(0.5);
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < samples; ++i) {
+                for (std::size_t j = 0; j < Parallel; ++j) {
+                    ::benchmark::DoNotOptimize(filter.processBatch(input[i], 0, j));
+                }
+
+                filter.finalizeBatches();
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples * Parallel);
+    }
+
+    BENCHMARK_TEMPLATE(BiquadProcessBatch, 1)->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(BiquadProcessBatch, 4)->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(BiquadProcessBatch, 8)->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(BiquadProcessBatch, 16)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    void AntiAliasFilterProcess(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = stereoNoise(samples);
+
+        AntiAliasFilter<> filter;
+        filter.sampleRate = 2 * SampleRate;
+        filter.cutoff = SampleRate / 2;
+        filter.recalculateCoefficients();
+
+        for (auto _ : state) {
+            for (auto& sample : input) {
+                ::benchmark::DoNotOptimize(filter.process(sample));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+        state.counters["stages"] = static_cast<double>(filter.stages.size());
+    }
+
+    BENCHMARK(AntiAliasFilterProcess)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    void EllipticFilterProcess(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = stereoNoise(samples);
+
+        EllipticParameters parameters;
+        parameters.sampleRate = 2 * SampleRate;
+        parameters.f0 = SampleRate / 2 - 2;
+        parameters.recalculateParameters();
+
+        EllipticFilter filter;
+
+        for (auto _ : state) {
+            for (auto& sample : input) {
+                ::benchmark::DoNotOptimize(filter.process(sample, parameters));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+        state.counters["sections"] = static_cast<double>(parameters.coeficients.size());
+    }
+
+    BENCHMARK(EllipticFilterProcess)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    // 8 band EQ, like the one on every voice, per sample (direct form I)
+    // versus per block (transposed direct form II cascade).
+    template<bool Block>
+    void Equalizer8(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = noise(samples);
+        std::vector<float> buffer(samples);
+
+        BatchEqualizer<8, Math, 1, 1> equalizer;
+        equalizer.prepare(SampleRate, MaxBlockSize);
+        for (std::size_t band = 0; band < equalizer.size(); ++band) {
+            equalizer[band].type(FilterType::PeakingEQ);
+            equalizer[band].frequency(100 * (band + 1) * (band + 1));
+            equalizer[band].gain(band % 2 ? 6 : -6);
+            equalizer[band].resonance(0.5);
+        }
+
+        // Filtered output is not fed back, so the levels stay the same every run
+        for (auto _ : state) {
+            std::copy(input.begin(), input.end(), buffer.begin());
+            if constexpr (Block) {
+                equalizer.processBlock(std::span{ buffer }, 0);
+                equalizer.finalizeBlock(samples);
+            } else {
+                for (auto& sample : buffer) {
+                    sample = equalizer.processBatch(sample, 0);
+                    equalizer.finalizeBatches();
+                }
+            }
+
+            ::benchmark::DoNotOptimize(buffer.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    BENCHMARK_TEMPLATE(Equalizer8, false)->Name("Equalizer8ProcessBatch")->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(Equalizer8, true)->Name("Equalizer8ProcessBlock")->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    // Cutoff changes every sample, like an envelope or lfo at audio rate.
+    template<class Filter>
+    void ModulatedCutoff(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const auto input = noise(samples);
+
+        Filter filter;
+        filter.sampleRate(SampleRate);
+        filter.type(FilterType::LowPass);
+        filter.resonance(0.5);
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < samples; ++i) {
+                const float cutoff = 200 + 4000 * (i % 64) / 64.f;
+                if constexpr (std::same_as<Filter, Biquad<Math::Fast>>) {
+                    filter.frequency(cutoff);
+                    ::benchmark::DoNotOptimize(filter.processBatch(input[i], 0));
+                    filter.finalizeBatches();
+                } else {
+                    ::benchmark::DoNotOptimize(filter.processBatch(input[i], cutoff, 0));
+                }
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    BENCHMARK_TEMPLATE(ModulatedCutoff, Biquad<Math::Fast>)->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(ModulatedCutoff, StateVariableFilter<Math::Fast>)->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(ModulatedCutoff, LadderFilter<Math::Fast>)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,57 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    // Applies the function to 1024 inputs in [min, max].
+    void MathFunction(::benchmark::State& state, float min, float max, auto function) {
+        constexpr std::size_t Inputs = 1024;
+        auto inputs = noise(Inputs);
+        for (auto& x : inputs) x = min + (x * 0.5f + 0.5f) * (max - min);
+
+        std::vector<float> outputs(Inputs);
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < Inputs; ++i) {
+                outputs[i] = function(inputs[i]);
+            }
+
+            ::benchmark::DoNotOptimize(outputs.data());
+            ::benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * Inputs);
+    }
+
+    // ------------------------------------------------
+
+    BENCHMARK_CAPTURE(MathFunction, Fast::exp2, -10.f, 10.f, [](float x) { return Math::Fast::exp2(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::exp, -10.f, 10.f, [](float x) { return Math::Fast::exp(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::log2, 0.001f, 100.f, [](float x) { return Math::Fast::log2(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::pow, 0.f, 4.f, [](float x) { return Math::Fast::pow(x, 1.5f); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::sqrt, 0.f, 100.f, [](float x) { return Math::Fast::sqrt(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::nsin, -1.f, 1.f, [](float x) { return Math::Fast::nsin(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::ncos, -1.f, 1.f, [](float x) { return Math::Fast::ncos(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::tanh, -5.f, 5.f, [](float x) { return Math::Fast::tanh(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::tanh_like, -5.f, 5.f, [](float x) { return Math::Fast::tanh_like(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::curve, 0.f, 1.f, [](float x) { return Math::Fast::curve(x, 0.3f); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::db_to_magnitude, -60.f, 12.f, [](float x) { return Math::Fast::db_to_magnitude(x); });
+    BENCHMARK_CAPTURE(MathFunction, Fast::magnitude_to_db, 0.001f, 4.f, [](float x) { return Math::Fast::magnitude_to_db(x); });
+
+    // Standard library versions, as a baseline.
+    BENCHMARK_CAPTURE(MathFunction, std::exp2, -10.f, 10.f, [](float x) { return std::exp2(x); });
+    BENCHMARK_CAPTURE(MathFunction, std::log2, 0.001f, 100.f, [](float x) { return std::log2(x); });
+    BENCHMARK_CAPTURE(MathFunction, std::sin, -1.f, 1.f, [](float x) { return std::sin(x * 2 * std::numbers::pi_v<float>); });
+    BENCHMARK_CAPTURE(MathFunction, std::tanh, -5.f, 5.f, [](float x) { return std::tanh(x); });
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
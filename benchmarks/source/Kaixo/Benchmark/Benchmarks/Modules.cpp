@@ -0,0 +1,156 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Modules/BatchEnvelope.hpp"
+#include "Kaixo/Core/Processing/Modules/Envelope.hpp"
+#include "Kaixo/Core/Processing/Modules/Lfo.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Short segments, so every block goes through attack, decay and release.
+    static void configure(Envelope& envelope) {
+        envelope.attack(2);
+        envelope.decay(5);
+        envelope.sustain(0.5);
+        envelope.release(5);
+        envelope.attackCurve(0.3);
+        envelope.decayCurve(0.7);
+        envelope.releaseCurve(0.7);
+    }
+
+    void EnvelopeProcess(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+
+        Envelope envelope;
+        prepare(envelope);
+        configure(envelope);
+
+        for (auto _ : state) {
+            envelope.trigger();
+            for (std::size_t i = 0; i < samples; ++i) {
+                if (i == samples / 2) envelope.release();
+                envelope.process();
+                ::benchmark::DoNotOptimize(envelope.output);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    void EnvelopeProcessBlock(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        std::vector<float> output(samples);
+
+        Envelope envelope;
+        prepare(envelope);
+        configure(envelope);
+
+        for (auto _ : state) {
+            envelope.trigger();
+            envelope.processBlock(std::span{ output }.first(samples / 2));
+            envelope.release();
+            envelope.processBlock(std::span{ output }.subspan(samples / 2));
+            ::benchmark::DoNotOptimize(output.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    BENCHMARK(EnvelopeProcess)->Apply(blockSizes);
+    BENCHMARK(EnvelopeProcessBlock)->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    // 4 voices with staggered releases, so the lanes transition at different samples.
+    // Items are voice samples, so the numbers compare to EnvelopeProcess.
+    template<bool Simd>
+    void BatchEnvelopeProcess(::benchmark::State& state) {
+        constexpr std::size_t Lanes = 4;
+        using SimdType = basic_simd<float, 32 * Lanes>;
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+
+        BatchEnvelope<Lanes> envelope;
+        prepare(envelope);
+        envelope.attack(2.f);
+        envelope.decay(5.f);
+        envelope.sustain(0.5f);
+        envelope.release(5.f); // float overload sets the time, size_t releases a lane
+        envelope.attackCurve(0.3f);
+        envelope.decayCurve(0.7f);
+        envelope.releaseCurve(0.7f);
+
+        for (auto _ : state) {
+            for (std::size_t lane = 0; lane < Lanes; ++lane) envelope.trigger(lane);
+            for (std::size_t i = 0; i < samples; ++i) {
+                if (i % (samples / 8) == 0 && i >= samples / 2) envelope.release((i * 8 / samples) % Lanes);
+                if constexpr (Simd) {
+                    ::benchmark::DoNotOptimize(envelope.template process<SimdType>());
+                } else {
+                    envelope.process();
+                    ::benchmark::DoNotOptimize(envelope.output);
+                }
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples * Lanes);
+    }
+
+    BENCHMARK_TEMPLATE(BatchEnvelopeProcess, false)->Name("BatchEnvelopeProcess")->Apply(blockSizes);
+    BENCHMARK_TEMPLATE(BatchEnvelopeProcess, true)->Name("BatchEnvelopeProcessSimd")->Apply(blockSizes);
+
+    // ------------------------------------------------
+
+    // Lfo shape with the given amount of points, evenly spread.
+    static Lfo::Storage shape(std::size_t points) {
+        Lfo::Storage storage;
+        for (std::size_t i = 0; i < points; ++i) {
+            const float x = static_cast<float>(i) / points;
+            storage.push_back({ .x = x, .y = Math::Fast::nsin(x) * 0.5f + 0.5f, .c = 0.5f });
+        }
+        return storage;
+    }
+
+    void LfoProcessBlock(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        std::vector<float> output(samples);
+
+        Lfo::Storage storage = shape(static_cast<std::size_t>(state.range(1)));
+
+        Lfo lfo;
+        prepare(lfo);
+        lfo.link(storage);
+        lfo.sync(Lfo::Sync::Seconds);
+        lfo.mode(Lfo::Mode::Trigger);
+        lfo.frequency(2);
+        lfo.mix(1);
+        lfo.trigger();
+
+        for (auto _ : state) {
+            lfo.processBlock(output);
+            ::benchmark::DoNotOptimize(output.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+    }
+
+    BENCHMARK(LfoProcessBlock)
+        ->ArgNames({ "samples", "points" })
+        ->ArgsProduct({ { 32, 512, 2048 }, { 4, 16, 64 } });
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,46 @@
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Oversampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Upsamples and downsamples a 512 sample block, with nothing in between.
+    void OversamplerRoundTrip(::benchmark::State& state) {
+        constexpr std::size_t Samples = 512;
+        auto block = stereoNoise(Samples);
+
+        Oversampler oversampler;
+        oversampler.factor(static_cast<std::size_t>(state.range(0)));
+        oversampler.phase(state.range(1) ? Oversampler::Phase::Linear : Oversampler::Phase::Minimum);
+        oversampler.prepare(Samples);
+
+        for (auto _ : state) {
+            ::benchmark::DoNotOptimize(oversampler.upsample(block).data());
+            oversampler.downsample(block);
+            ::benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * Samples);
+    }
+
+    BENCHMARK(OversamplerRoundTrip)
+        ->ArgNames({ "factor", "linear" })
+        ->ArgsProduct({ { 2, 4, 8, 16 }, { 0, 1 } });
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,49 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/PointStorage.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Looks up 1024 random positions in a shape with evenly spread points.
+    void PointStorageAt(::benchmark::State& state) {
+        constexpr std::size_t Lookups = 1024;
+        const std::size_t points = static_cast<std::size_t>(state.range(0));
+
+        PointStorage<100> storage;
+        for (std::size_t i = 0; i < points; ++i) {
+            const float x = static_cast<float>(i) / points;
+            storage.push_back({ .x = x, .y = x * x, .c = 0.3f });
+        }
+
+        auto positions = noise(Lookups);
+        for (auto& x : positions) x = x * 0.5f + 0.5f;
+
+        for (auto _ : state) {
+            for (float x : positions) {
+                ::benchmark::DoNotOptimize(storage.at(x));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * Lookups);
+    }
+
+    BENCHMARK(PointStorageAt)->Arg(2)->Arg(8)->Arg(32)->Arg(100);
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
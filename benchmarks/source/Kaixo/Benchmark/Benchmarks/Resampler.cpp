@@ -0,0 +1,93 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Resampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Generates 512 output samples from noise at the input sample rate.
+    void ResamplerGenerate(::benchmark::State& state) {
+        constexpr std::size_t Samples = 512;
+        const auto input = stereoNoise(Samples * 4);
+
+        Resampler resampler;
+        resampler.samplerate.in = static_cast<double>(state.range(0));
+        resampler.samplerate.out = static_cast<double>(state.range(1));
+
+        std::size_t read = 0;
+        auto generator = [&] { 
+            read = read + 1 == input.size() ? 0 : read + 1;
+            return input[read];
+        };
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < Samples; ++i) {
+                ::benchmark::DoNotOptimize(resampler.generate(generator));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * Samples);
+    }
+
+    BENCHMARK(ResamplerGenerate)
+        ->ArgNames({ "in", "out" })
+        ->Args({ 44100, 48000 })
+        ->Args({ 48000, 44100 })
+        ->Args({ 96000, 48000 })
+        ->Args({ 192000, 48000 });
+
+    // ------------------------------------------------
+
+    // Resamples noise into 512 output samples per iteration, feeding the input as spans.
+    void ResamplerProcess(::benchmark::State& state) {
+        constexpr std::size_t Samples = 512;
+        const auto input = stereoNoise(Samples * 4);
+        std::vector<Stereo> output(Samples);
+
+        Resampler resampler;
+        resampler.samplerate.in = static_cast<double>(state.range(0));
+        resampler.samplerate.out = static_cast<double>(state.range(1));
+
+        std::size_t read = 0;
+        for (auto _ : state) {
+            std::size_t produced = 0;
+            while (produced < Samples) {
+                auto result = resampler.process(
+                    std::span{ input }.subspan(read),
+                    std::span{ output }.subspan(produced));
+                produced += result.produced;
+                read += result.consumed;
+                if (read == input.size()) read = 0;
+            }
+
+            ::benchmark::DoNotOptimize(output.data());
+            ::benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * Samples);
+    }
+
+    BENCHMARK(ResamplerProcess)
+        ->ArgNames({ "in", "out" })
+        ->Args({ 44100, 48000 })
+        ->Args({ 48000, 44100 })
+        ->Args({ 96000, 48000 })
+        ->Args({ 192000, 48000 });
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,112 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/VoiceBank.hpp"
+#include "Kaixo/Core/Processing/Filter.hpp"
+#include "Kaixo/Core/Processing/Modules/Envelope.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Benchmark {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    // Filtered saw with an envelope, roughly the work of a simple synth voice.
+    class BenchmarkVoice : public Voice {
+    public:
+
+        // ------------------------------------------------
+
+        Envelope envelope;
+        Biquad<Math, 1, 1> filter;
+
+        // ------------------------------------------------
+
+        BenchmarkVoice() {
+            registerModule(envelope);
+            envelope.attack(5);
+            envelope.decay(200);
+            envelope.sustain(0.5);
+            envelope.release(100);
+            filter.type(FilterType::LowPass);
+            filter.frequency(3000);
+            filter.resonance(0.3);
+        }
+
+        // ------------------------------------------------
+
+        void trigger() override { envelope.trigger(); }
+        void release() override { envelope.release(); }
+        bool active() const override { return envelope.active(); }
+
+        // ------------------------------------------------
+
+        void prepare(double sampleRate, std::size_t maxBufferSize) override {
+            ModuleContainer::prepare(sampleRate, maxBufferSize);
+            filter.sampleRate(sampleRate);
+        }
+
+        void process() override {
+            const float delta = noteToFreq(note) / sampleRate();
+            for (std::size_t i = 0; i < output.size(); ++i) {
+                envelope.process();
+                m_Phase = Math::Fast::fmod1(m_Phase + delta);
+                const float saw = 2 * m_Phase - 1;
+                output[i] = filter.process(Stereo{ saw, saw }) * envelope.output;
+            }
+        }
+
+        // ------------------------------------------------
+
+    private:
+        float m_Phase = 0;
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    // Arguments are the block size, the amount of held voices, and whether to use threading.
+    void VoiceBankProcess(::benchmark::State& state) {
+        const std::size_t samples = static_cast<std::size_t>(state.range(0));
+        const std::size_t voices = static_cast<std::size_t>(state.range(1));
+
+        auto bank = std::make_unique<VoiceBank<BenchmarkVoice, 32>>();
+        prepare(*bank);
+        bank->threading(state.range(2) != 0);
+
+        for (std::size_t i = 0; i < voices; ++i) {
+            bank->noteOn(static_cast<Note>(36 + i), 1, 1);
+        }
+
+        Buffer& output = bank->outputBuffer();
+
+        for (auto _ : state) {
+            output.prepare(samples);
+            bank->process();
+            ::benchmark::DoNotOptimize(output.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * samples);
+        state.counters["active"] = static_cast<double>(bank->activeVoices());
+    }
+
+    BENCHMARK(VoiceBankProcess)
+        ->ArgNames({ "samples", "voices", "threading" })
+        ->ArgsProduct({ { 64, 512 }, { 1, 4, 8, 16, 32 }, { 0, 1 } })
+        ->UseRealTime();
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,26 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Benchmark/Benchmark.hpp"
+
+// ------------------------------------------------
+
+int main(int argc, char** argv) {
+
+    // ------------------------------------------------
+
+    juce::ScopedJuceInitialiser_GUI initialiser;
+
+    // ------------------------------------------------
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -137,6 +137,8 @@ namespace Kaixo::Generator {
         param.transform = xml.attributeOr("transform", param.transform);
         param.format = xml.attributeOr("format", param.format);
         param.smooth = xml.attributeOr("smooth", param.smooth);
+        param.smoothTime = xml.attributeOr("smooth-time", param.smoothTime);
+        param.controlRate = xml.attributeOr("control-rate", param.controlRate);
         param.multiply = xml.attributeOr("multiply", param.multiply);
         param.constrain = xml.attributeOr("constrain", param.constrain);
         param.modulatable = xml.attributeOr("modulatable", param.modulatable);
@@ -160,7 +162,9 @@ namespace Kaixo::Generator {
         param.steps = xml.attributeOr("steps", "0");
         param.transform = xml.attributeOr("transform", "Default");
         param.format = xml.attributeOr("format", "Default");
-        param.smooth = xml.attributeOr("smooth", "true");
+        param.smooth = xml.attributeOr("smooth", "true"); // true, false, linear, or exponential
+        param.smoothTime = xml.attributeOr("smooth-time", "0"); // Milliseconds, 0 for the database default
+        param.controlRate = xml.attributeOr("control-rate", "1"); // Samples between recomputing the modulation
         param.multiply = xml.attributeOr("multiply", "false");
         param.constrain = xml.attributeOr("constrain", "true");
         param.modulatable = xml.attributeOr("modulatable", "true");
@@ -266,6 +270,7 @@ namespace Kaixo::Generator {
         source.varName = xml.attributeOr("var-name", nameToVar(source.name));
         source.description = xml.attributeOr("description", "");
         source.bidirectional = xml.attributeOr("bidirectional", "false");
+        source.controlRate = xml.attributeOr("control-rate", "1"); // Samples between evaluating the source
         source.interface = xml.attributeOr("interface", "");
 
         sources[source.id] = &source;
@@ -490,11 +495,14 @@ namespace Kaixo::Generator {
         add(".steps = " + param.steps + ", ");
         add(".transform = Transformers::" + param.transform + ", ");
         add(".format = Formatters::" + param.format + ", ");
-        add(".smooth = " + param.smooth + ", ");
+        add(".smooth = "s + (param.smooth != "false" ? "true" : "false") + ", ");
         add(".multiply = " + param.multiply + ", ");
         add(".constrain = " + param.constrain + ", ");
         add(".modulatable = " + param.modulatable + ", ");
         add(".automatable = " + param.automatable + ", ");
+        add(".smoothing = Smoothing::"s + (param.smooth == "exponential" ? "Exponential" : "Linear") + ", ");
+        add(".smoothTime = " + param.smoothTime + ", ");
+        add(".controlRate = " + param.controlRate + ", ");
     }
 
     void ParameterGenerator::instantiateSource(Source& source) {
@@ -509,6 +517,7 @@ namespace Kaixo::Generator {
         add(".fullVarName = \"" + source.fullVarName + "\", ");
         add(".description = \"" + source.description + "\", ");
         add(".bidirectional = " + source.bidirectional + ", ");
+        add(".controlRate = " + source.controlRate + ", ");
     }
 
     // ------------------------------------------------
@@ -637,8 +646,21 @@ namespace Kaixo::Generator {
         add();
         add("namespace Kaixo::Processing {");
 
+        std::size_t smoothed = 0;
+        for (auto& [id, param] : parameters) {
+            if (param->steps == "0" && param->smooth != "false") ++smoothed;
+        }
+
         if (interfaceType == "modulation") {
             add("#define KAIXO_INTERNAL_MODULATION");
+        }
+
+        add();
+        add("// ------------------------------------------------", 1);
+        add();
+        add("constexpr std::size_t nofSmoothedParameters() { return " + std::to_string(smoothed) + "; }", 1);
+
+        if (interfaceType == "modulation") {
             add();
             add("// ------------------------------------------------", 1);
             add();
@@ -658,107 +680,60 @@ namespace Kaixo::Generator {
                 }
 
                 if (!accessor.empty()) {
+                    // Control rate sources are only evaluated when due, the database interpolates
+                    int indent = source->controlRate == "1" ? 3 : 4;
                     add("// Source: " + source->fullVarName, 2);
                     add("if constexpr (((Names == \"" + name + "\") || ...)) {", 2);
-                    add("auto& s = database.source(" + idstr + ");", 3);
+                    if (indent == 4) add("if (database.due(" + source->controlRate + ")) {", 3);
                     if (source->bidirectional == "true") {
-                        add("s.normalized = " + accessor + ";", 3);
-                        add("s.value = s.normalized * 2 - 1;", 3);
+                        add("const float normalized = " + accessor + ";", indent);
+                        add("database.source(" + idstr + ", normalized * 2 - 1, normalized);", indent);
                     } else {
-                        add("s.value = s.normalized = " + accessor + ";", 3);
+                        add("database.source(" + idstr + ", " + accessor + ");", indent);
                     }
+                    if (indent == 4) add("}", 3);
                     add("}", 2);
                 }
             }
             add("}", 1);
-            add();
-            add("// ------------------------------------------------", 1);
-            add();
-            add("template<string_literal ...Names>", 1);
-            add("constexpr void assignParameters(auto& database) {", 1);
-            add("using Self = std::decay_t<decltype(database.self())>;", 2);
-            for (auto& [id, param] : parameters) {
-                std::string idstr = std::to_string(id);
-                std::string accessor = param->interface;
-                std::string name = accessor;
-
-                if (!accessor.empty()) {
-                    replace_str(accessor, "$value", "p.access");
+        }
 
-                    name = name.substr(name.find_first_of("$"));
-                    name = name.substr(0, name.find_first_not_of("$abcdefghijklmnopqrstuvwxyz_0123456789"));
+        // Only the parameters that are ramping or modulated are visited, the ramps
+        // and the modulation are already applied by the database.
+        add();
+        add("// ------------------------------------------------", 1);
+        add();
+        add("template<string_literal ...Names>", 1);
+        add("constexpr void assignParameters(auto& database) {", 1);
+        add("using Self = std::decay_t<decltype(database.self())>;", 2);
+        add("database.foreachChanging([&](ParamID id) {", 2);
+        add("switch (id) {", 3);
+        for (auto& [id, param] : parameters) {
+            std::string idstr = std::to_string(id);
+            std::string accessor = param->interface;
+            std::string name = accessor;
 
-                    replace_str(accessor, name, "database.self()");
-                }
+            if (!accessor.empty()) {
+                replace_str(accessor, "$value", "database.access(" + idstr + ")");
 
-                if (param->steps == "0" && param->smooth != "false") {
-                    add("// Parameter: " + param->fullVarName, 2);
-                    add("if (database.necessary(" + idstr + ")) {", 2);
-                    add("auto& p = database.parameter(" + idstr + ");", 3);
-                    if (param->modulatable == "true") {
-                        add("float value = p.value += p.add;", 3);
-                        if (param->multiply == "true") {
-                            add("database.loopOverSources(" + idstr + ", [&](ModulationSourceID source, float amount) {", 3);
-                            add("value *= amount * database.source(source).normalized + Math::Fast::min(1 - amount, 1);", 4);
-                            add("});", 3);
-                        }
-                        else {
-                            add("database.loopOverSources(" + idstr + ", [&](ModulationSourceID source, float amount) {", 3);
-                            add("value += amount * database.source(source).value;", 4);
-                            add("});", 3);
-                        }
+                name = name.substr(name.find_first_of("$"));
+                name = name.substr(0, name.find_first_not_of("$abcdefghijklmnopqrstuvwxyz_0123456789"));
 
-                        if (param->constrain == "true") {
-                            add("p.access = Math::Fast::clamp1(value);", 3);
-                        } else {
-                            add("p.access = value;", 3);
-                        }
-                    } else {
-                        add("p.access = p.value += p.add;", 3);
-                    }
-                    if (!accessor.empty()) {
-                        add("if constexpr (((Names == \"" + name + "\") || ...)) {", 3);
-                        add(accessor + ";", 4);
-                        add("}", 3);
-                    }
-                    add("}", 2);
-                }
+                replace_str(accessor, name, "database.self()");
             }
-            add("}", 1);
-        }
-        else if (interfaceType == "normal") {
-            add("template<string_literal ...Names>", 1);
-            add("constexpr void assignParameters(auto& database) {", 1);
-            for (auto& [id, param] : parameters) {
-                std::string idstr = std::to_string(id);
-                std::string accessor = param->interface;
-                std::string name = accessor;
-
-                if (!accessor.empty()) {
-                    replace_str(accessor, "$value", "p.access");
-
-                    name = name.substr(name.find_first_of("$"));
-                    name = name.substr(0, name.find_first_not_of("$abcdefghijklmnopqrstuvwxyz_0123456789"));
-
-                    replace_str(accessor, name, "database.self()");
-                }
 
+            if (param->steps != "0" || param->smooth == "false" || accessor.empty()) continue;
 
-                if (param->steps == "0" && param->smooth != "false") {
-                    add("// Parameter: " + param->fullVarName, 2);
-                    add("if (database.necessary(" + idstr + ")) {", 2);
-                    add("auto& p = database.parameter(" + idstr + ");", 3);
-                    add("p.access = p.value += p.add;", 3);
-                    if (!accessor.empty()) {
-                        add("if constexpr (((Names == \"" + name + "\") || ...)) {", 3);
-                        add(accessor + ";", 4);
-                        add("}", 3);
-                    }
-                    add("}", 2);
-                }
-            }
-            add("}", 1);
+            add("case " + idstr + ": { // Parameter: " + param->fullVarName, 3);
+            add("if constexpr (((Names == \"" + name + "\") || ...)) {", 4);
+            add(accessor + ";", 5);
+            add("}", 4);
+            add("break;", 4);
+            add("}", 3);
         }
+        add("}", 3);
+        add("});", 2);
+        add("}", 1);
         add();
         add("// ------------------------------------------------", 1);
         add();
@@ -771,7 +746,7 @@ namespace Kaixo::Generator {
             std::string name = accessor;
 
             if (!accessor.empty()) {
-                replace_str(accessor, "$value", "p.access");
+                replace_str(accessor, "$value", "database.access(" + idstr + ")");
 
                 name = name.substr(name.find_first_of("$"));
                 name = name.substr(0, name.find_first_not_of("$abcdefghijklmnopqrstuvwxyz_0123456789"));
@@ -781,17 +756,13 @@ namespace Kaixo::Generator {
 
             add("case " + idstr + ": { // Parameter: " + param->fullVarName, 2);
             if (param->steps == "0" && param->smooth != "false") {
-                add("auto& p = database.parameter(" + idstr + ");", 3);
                 if (alwaysActive) {
-                    add("p.goal = val;", 3);
-                    add("database.setChanging(" + idstr + ");", 3);
+                    add("database.ramp(" + idstr + ", val);", 3);
                 } else {
                     add("if (database.self().active()) {", 3);
-                    add("p.goal = val;", 4);
-                    add("database.setChanging(" + idstr + ");", 4);
+                    add("database.ramp(" + idstr + ", val);", 4);
                     add("} else {", 3);
-                    add("p.access = p.value = p.goal = val;", 4);
-                    add("p.add = 0;", 4);
+                    add("database.snap(" + idstr + ", val);", 4);
                     if (!accessor.empty()) {
                         add("if constexpr (((Names == \"" + name + "\") || ...)) {", 4);
                         add(accessor + ";", 5);
@@ -800,9 +771,7 @@ namespace Kaixo::Generator {
                     add("}", 3);
                 }
             } else {
-                add("auto& p = database.parameter(" + idstr + ");", 3);
-                add("p.access = p.value = p.goal = val;", 3);
-                add("p.add = 0;", 3);
+                add("database.snap(" + idstr + ", val);", 3);
                 if (!accessor.empty()) {
                     add("if constexpr (((Names == \"" + name + "\") || ...)) {", 3);
                     add(accessor + ";", 4);
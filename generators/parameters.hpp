@@ -39,6 +39,7 @@ namespace Kaixo::Generator {
             std::string description{};
             std::string varName{};
             std::string bidirectional{};
+            std::string controlRate{};
             std::string interface {};
 
             // ------------------------------------------------
@@ -74,6 +75,8 @@ namespace Kaixo::Generator {
             std::string transform{};
             std::string format{};
             std::string smooth{};
+            std::string smoothTime{};
+            std::string controlRate{};
             std::string multiply{};
             std::string constrain{};
             std::string modulatable{};
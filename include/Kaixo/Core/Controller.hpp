@@ -56,6 +56,11 @@ namespace Kaixo {
 
         // ------------------------------------------------
 
+        void handleMidiMessage(const juce::MidiMessage& message);
+        void renderSlice(juce::AudioBuffer<float>& buffer, std::size_t offset, std::size_t samples);
+
+        // ------------------------------------------------
+
         juce::AudioProcessorEditor* createEditor() override;
         bool hasEditor() const override { return true; }
 
@@ -120,9 +125,24 @@ namespace Kaixo {
 
         // ------------------------------------------------
         
+        // The host block is split at the sample position of every midi event, 
+        // so notes start at their exact offset. Events that arrive within this
+        // many samples of the start of the current slice are applied at the start 
+        // of that slice, to prevent tiny slices from killing throughput.
+        void minimumSliceSize(std::size_t samples) { m_MinimumSliceSize = Math::max(samples, 1ull); }
+        std::size_t minimumSliceSize() const { return m_MinimumSliceSize; }
+
+        // ------------------------------------------------
+        
         template<std::derived_from<Processing::Interface> Ty>
         Ty* interface() { return m_Processor->interface<Ty>(); }
 
+        // ------------------------------------------------
+
+        // Give a module that is not part of the processor access to the
+        // sample rate, tempo and output buffer, for tools like benchmarks.
+        void attach(Processing::Module& module) { module.setController(this); }
+
         // ------------------------------------------------
         
         template<std::derived_from<Serializable> Ty>
@@ -134,6 +154,10 @@ namespace Kaixo {
         std::unique_ptr<Processing::Processor> m_Processor;
         Gui::Window* m_Window = nullptr;
 
+#ifdef KAIXO_PROFILE_MODULES
+        Processing::Profiler m_Profiler{};
+#endif
+
         // ------------------------------------------------
         
         MPEInstrument m_MPEInstrument{};
@@ -141,6 +165,7 @@ namespace Kaixo {
         // ------------------------------------------------
 
         std::vector<Parameter*> m_Parameters{};
+        ParameterChanges m_ParameterChanges{ Kaixo::nofParameters() };
         
         // ------------------------------------------------
 
@@ -151,6 +176,7 @@ namespace Kaixo {
         std::int64_t m_TimeInSamples = 0;
         juce::AudioPlayHead::TimeSignature m_TimeSignature{};
         std::size_t m_Oversample = 1;
+        std::size_t m_MinimumSliceSize = 32;
         bool m_Offline = false;
 
         ParamID m_PitchWheelLinkedParameter = NoParam;
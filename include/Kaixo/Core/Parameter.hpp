@@ -11,6 +11,10 @@ namespace Kaixo {
 
     // ------------------------------------------------
 
+    enum class Smoothing { Linear, Exponential };
+
+    // ------------------------------------------------
+
     struct ParameterSettings {
 
         // ------------------------------------------------
@@ -47,6 +51,12 @@ namespace Kaixo {
 
         // ------------------------------------------------
 
+        Smoothing smoothing = Smoothing::Linear;
+        float smoothTime = 0; // Milliseconds, 0 for the default of the ParameterDatabase
+        std::size_t controlRate = 1; // Samples between recomputing the modulation, interpolated in between
+
+        // ------------------------------------------------
+
         std::string toString(ParamValue val) const { return format.format(transform.transform(val)); }
         ParamValue fromString(std::string_view val) const { return transform.normalize(format.parse(val)); }
 
@@ -82,6 +92,77 @@ namespace Kaixo {
         return *p;
     }
 
+    // ------------------------------------------------
+
+    /**
+     * Tracks which parameters changed, separately for every consumer (the audio
+     * thread and the gui), so they only visit the parameters that actually changed.
+     * Marking is lock-free and can happen from any thread, but every consumer
+     * should only be consumed from a single thread. Changes are kept in a bitset
+     * per consumer, with a summary bitset of non-empty words on top of it.
+     */
+    class ParameterChanges {
+    public:
+
+        // ------------------------------------------------
+
+        enum class Consumer { Audio, Gui, Amount };
+
+        // ------------------------------------------------
+
+        ParameterChanges(std::size_t parameters) {
+            const std::size_t words = (parameters + 63) / 64;
+            for (auto& set : m_Sets) {
+                set.words = std::vector<std::atomic<std::uint64_t>>(words);
+                set.summary = std::vector<std::atomic<std::uint64_t>>((words + 63) / 64);
+            }
+        }
+
+        // ------------------------------------------------
+
+        void mark(ParamID id) {
+            const std::size_t word = id / 64;
+            for (auto& set : m_Sets) {
+                // Word before summary, so the consumer never clears
+                // the summary bit of a word it has not yet seen.
+                set.words[word].fetch_or(1ull << (id % 64), std::memory_order_release);
+                set.summary[word / 64].fetch_or(1ull << (word % 64), std::memory_order_release);
+            }
+        }
+
+        // Call fun(ParamID) for every parameter changed since the last consume.
+        template<class Fun>
+        void consume(Consumer consumer, Fun fun) {
+            auto& set = m_Sets[static_cast<std::size_t>(consumer)];
+            for (std::size_t i = 0; i < set.summary.size(); ++i) {
+                std::uint64_t summary = set.summary[i].exchange(0, std::memory_order_acquire);
+                while (summary) {
+                    const std::size_t word = i * 64 + std::countr_zero(summary);
+                    summary &= summary - 1;
+
+                    std::uint64_t bits = set.words[word].exchange(0, std::memory_order_acquire);
+                    while (bits) {
+                        fun(static_cast<ParamID>(word * 64 + std::countr_zero(bits)));
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        }
+
+        // ------------------------------------------------
+
+    private:
+        struct Set {
+            std::vector<std::atomic<std::uint64_t>> words{};
+            std::vector<std::atomic<std::uint64_t>> summary{};
+        };
+
+        std::array<Set, static_cast<std::size_t>(Consumer::Amount)> m_Sets{};
+
+        // ------------------------------------------------
+
+    };
+
     // ------------------------------------------------
     
     class Parameter : public juce::AudioProcessorParameter {
@@ -89,8 +170,9 @@ namespace Kaixo {
 
         // ------------------------------------------------
 
-        Parameter(const ParameterSettings& settings) 
+        Parameter(const ParameterSettings& settings, ParameterChanges* changes = nullptr) 
             : m_Settings(&settings), 
+            m_Changes(changes),
             m_PrecalculatedNormalizedDefaultValue(m_Settings->normalizedDefaultValue()),
             m_NormalizedValue(m_PrecalculatedNormalizedDefaultValue)
         {}
@@ -104,7 +186,10 @@ namespace Kaixo {
         float getDefaultValue() const override { return defaultValue(); }
 
         float getValue()         const override { return value(); }
-        void  setValue(float newValue) override { m_NormalizedValue = newValue; }
+        void  setValue(float newValue) override { 
+            m_NormalizedValue = newValue; 
+            if (m_Changes) m_Changes->mark(m_Settings->id);
+        }
 
         // ------------------------------------------------
         
@@ -134,6 +219,7 @@ namespace Kaixo {
 
     protected:
         const ParameterSettings* m_Settings;
+        ParameterChanges* m_Changes;
         const ParamValue m_PrecalculatedNormalizedDefaultValue;
         ParamValue m_NormalizedValue = 0;
 
@@ -162,6 +248,7 @@ namespace Kaixo {
         // ------------------------------------------------
 
         bool bidirectional = false;
+        std::size_t controlRate = 1; // Samples between evaluating the source, interpolated in between
 
         // ------------------------------------------------
 
@@ -55,6 +55,14 @@ namespace Kaixo::Processing {
             std::memset(m_Data, 0, sizeof(Stereo) * m_CurrentSize);
         }
 
+        // Add the first s samples of other to this buffer. Loops over the
+        // floats directly so the compiler can vectorize it.
+        void add(const Buffer& other, std::size_t s) {
+            float* out = reinterpret_cast<float*>(m_Data);
+            const float* in = reinterpret_cast<const float*>(other.m_Data);
+            for (std::size_t i = 0; i < 2 * s; ++i) out[i] += in[i];
+        }
+
         void reserve(std::size_t s) {
             if (s > m_Size) resize(s);
             m_CurrentSize = s;
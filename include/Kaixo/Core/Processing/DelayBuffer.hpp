@@ -41,6 +41,25 @@ namespace Kaixo::Processing {
             m_Delay = m_Delay * m_Smooth + m_TargetDelay * (1 - m_Smooth);
         }
 
+        using Module::processBlock;
+
+        /**
+         * Process a block of samples, input and output must have the same size.
+         * The sample rate and buffer size are only looked up once per block.
+         */
+        void processBlock(std::span<const Stereo> in, std::span<Stereo> out) {
+            const float samplesPerMilli = sampleRate() / 1000.;
+            const std::size_t length = size();
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                m_Samples[m_Write] = in[i];
+                out[i] = readSamples(samplesPerMilli * m_Delay, length);
+                if (++m_Write == length) m_Write = 0;
+                m_Delay = m_Delay * m_Smooth + m_TargetDelay * (1 - m_Smooth);
+            }
+
+            if (!in.empty()) input = in.back(), output = out[in.size() - 1];
+        }
+
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
             resize(sampleRate * m_MaxDelay / 1000.);
             m_Smooth = Math::smoothCoef(0.99, 48000. / sampleRate);
@@ -54,12 +73,7 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
         Stereo read(float delayMs) const {
-            float delaySamples = sampleRate() * delayMs / 1000.;
-            float read = Math::Fast::fmod(m_Write + 2 * size() - delaySamples, size());
-            std::size_t delay1 = static_cast<std::size_t>(read);
-            std::size_t delay2 = static_cast<std::size_t>(read + 1) % size();
-            float ratio = read - delay1;
-            return m_Samples[delay2] * ratio + m_Samples[delay1] * (1 - ratio);
+            return readSamples(sampleRate() * delayMs / 1000., size());
         }
 
         // ------------------------------------------------
@@ -85,6 +99,16 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+        Stereo readSamples(float delaySamples, std::size_t length) const {
+            float read = Math::Fast::fmod(m_Write + 2 * length - delaySamples, length);
+            std::size_t delay1 = static_cast<std::size_t>(read);
+            std::size_t delay2 = static_cast<std::size_t>(read + 1) % length;
+            float ratio = read - delay1;
+            return m_Samples[delay2] * ratio + m_Samples[delay1] * (1 - ratio);
+        }
+
+        // ------------------------------------------------
+
     };
 
     // ------------------------------------------------
@@ -92,6 +92,21 @@ namespace Kaixo::Processing {
             }
         }
 
+        /**
+         * Recalculate the coefficients at most once every 'samples' samples, and
+         * interpolate to them linearly in between. This keeps modulation of the 
+         * frequency, resonance or gain from recalculating them every sample. 
+         * Interpolation advances in finalizeBatches(), 0 recalculates on every change.
+         * For cheaper recalculations use Math::Fast as MathQuality.
+         */
+        constexpr void interpolate(std::size_t samples) {
+            if (m_Remaining != 0) dirty = true; // Don't get stuck halfway
+            m_InterpolateSamples = samples;
+            m_Remaining = 0;
+        }
+
+        constexpr std::size_t interpolate() const { return m_InterpolateSamples; }
+
         // ------------------------------------------------
 
         bool bypass = false;
@@ -99,7 +114,7 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
         constexpr Coefficients& getCoefficients() {
-            if (dirty) recalculate();
+            if (dirty && (m_InterpolateSamples == 0 || !m_Calculated)) recalculate();
             return m_Coefficients;
         }
 
@@ -172,6 +187,14 @@ namespace Kaixo::Processing {
             m_2 = m_1;
             m_1 = m_0;
             m_0 = backup;
+
+            if (m_InterpolateSamples != 0) step();
+        }
+
+        // Advance the interpolation past a block that was filtered with these 
+        // coefficients outside of processBatch, like BatchEqualizer::processBlock.
+        constexpr void finalizeBlock(std::size_t samples) {
+            if (m_InterpolateSamples != 0) step(samples);
         }
 
         // ------------------------------------------------
@@ -204,9 +227,70 @@ namespace Kaixo::Processing {
         std::size_t m_1 = 1;
         std::size_t m_2 = 2;
 
+        bool m_Calculated = false;
+        std::size_t m_InterpolateSamples = 0;
+        std::size_t m_Remaining = 0; // Samples left in the current interpolation
+        Coefficients m_Target{};
+        Coefficients m_Delta{};      // Per sample, only the normalized coefficients
+
         // ------------------------------------------------
 
         constexpr void set(auto v, auto& me) { if (v != me) { me = v; dirty = true; } }
+
+        // ------------------------------------------------
+
+        // Advance the interpolation by a number of samples, starts a new one 
+        // when parameters changed since the last one was started.
+        constexpr void step(std::size_t samples = 1) {
+            while (samples > 0) {
+                if (m_Remaining == 0) {
+                    if (!dirty) return;
+                    start();
+                }
+
+                const std::size_t n = Math::min(samples, m_Remaining);
+                m_Remaining -= n;
+                samples -= n;
+
+                if (m_Remaining == 0) {
+                    m_Coefficients = m_Target;
+                } else {
+                    const float amount = static_cast<float>(n);
+                    m_Coefficients.b0a0 += amount * m_Delta.b0a0;
+                    m_Coefficients.b1a0 += amount * m_Delta.b1a0;
+                    m_Coefficients.b2a0 += amount * m_Delta.b2a0;
+                    m_Coefficients.a1a0 += amount * m_Delta.a1a0;
+                    m_Coefficients.a2a0 += amount * m_Delta.a2a0;
+                }
+            }
+        }
+
+        // Start interpolating from the current coefficients to the recalculated ones.
+        constexpr void start() {
+
+            const Coefficients current = m_Coefficients;
+            recalculate();
+            m_Target = m_Coefficients;
+
+            // Interpolating between 2 stable filters stays stable, as the 
+            // stability triangle of a1 and a2 is convex.
+            const float samples = static_cast<float>(m_InterpolateSamples);
+            m_Delta.b0a0 = (m_Target.b0a0 - current.b0a0) / samples;
+            m_Delta.b1a0 = (m_Target.b1a0 - current.b1a0) / samples;
+            m_Delta.b2a0 = (m_Target.b2a0 - current.b2a0) / samples;
+            m_Delta.a1a0 = (m_Target.a1a0 - current.a1a0) / samples;
+            m_Delta.a2a0 = (m_Target.a2a0 - current.a2a0) / samples;
+
+            m_Coefficients.b0a0 = current.b0a0;
+            m_Coefficients.b1a0 = current.b1a0;
+            m_Coefficients.b2a0 = current.b2a0;
+            m_Coefficients.a1a0 = current.a1a0;
+            m_Coefficients.a2a0 = current.a2a0;
+            m_Remaining = m_InterpolateSamples;
+        }
+
+        // ------------------------------------------------
+
         constexpr float normalizedFrequency() const { return MathQuality::clamp(m_Frequency / m_SampleRate, 0., 0.5); }
         constexpr float normalizedQ() const {
             using enum FilterType;
@@ -234,6 +318,7 @@ namespace Kaixo::Processing {
 
         constexpr void recalculate() {
             dirty = false;
+            m_Calculated = true;
             constexpr float log10_2 = std::numbers::ln2 / std::numbers::ln10;
             using enum FilterType;
             const float frequency = normalizedFrequency();
@@ -388,6 +473,559 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
+    /**
+     * Cascade of second order sections in transposed direct form II. Runs
+     * Lanes independent cascades side by side (voices, or channels), so they
+     * are processed with SIMD, every lane has its own coefficients and state.
+     * The filter design is done by a Biquad, use assign() to copy its passes
+     * into sections. Sections that are never assigned pass the signal through.
+     */
+    template<std::size_t Lanes = 1, std::size_t MaxStages = 8>
+    class BiquadCascade {
+    public:
+
+        // ------------------------------------------------
+
+        // Coefficients normalized by a0, defaults to pass-through.
+        struct Section {
+            float b0 = 1;
+            float b1 = 0;
+            float b2 = 0;
+            float a1 = 0;
+            float a2 = 0;
+        };
+
+        // ------------------------------------------------
+
+        constexpr std::size_t stages() const { return m_Stages; }
+        constexpr void stages(std::size_t stages) { m_Stages = Math::min(stages, MaxStages); }
+
+        // ------------------------------------------------
+
+        void section(std::size_t stage, std::size_t lane, Section section) {
+            m_B0[stage][lane] = section.b0;
+            m_B1[stage][lane] = section.b1;
+            m_B2[stage][lane] = section.b2;
+            m_A1[stage][lane] = section.a1;
+            m_A2[stage][lane] = section.a2;
+        }
+
+        void section(std::size_t stage, Section section) {
+            for (std::size_t lane = 0; lane < Lanes; ++lane) this->section(stage, lane, section);
+        }
+
+        /**
+         * Copy the coefficients of a biquad into the sections starting at stage,
+         * one section per pass. Bypassed filters don't use any sections.
+         * @return the amount of sections written
+         */
+        template<class Filter>
+        std::size_t assign(std::size_t stage, std::size_t lane, Filter& filter) {
+            if (filter.bypass) return 0;
+            auto& coeff = filter.getCoefficients();
+            const std::size_t passes = Math::min(filter.passes(), MaxStages - stage);
+            for (std::size_t i = 0; i < passes; ++i) {
+                section(stage + i, lane, { coeff.b0a0, coeff.b1a0, coeff.b2a0, coeff.a1a0, coeff.a2a0 });
+            }
+            return passes;
+        }
+
+        // Same filter in all lanes.
+        template<class Filter>
+        std::size_t assign(std::size_t stage, Filter& filter) {
+            std::size_t passes = 0;
+            for (std::size_t lane = 0; lane < Lanes; ++lane) passes = assign(stage, lane, filter);
+            return passes;
+        }
+
+        // ------------------------------------------------
+
+        void reset() {
+            std::memset(m_S1, 0, sizeof(m_S1));
+            std::memset(m_S2, 0, sizeof(m_S2));
+        }
+
+        // Clear the state of some sections, in all lanes.
+        void reset(std::size_t stage, std::size_t count) {
+            count = Math::min(count, MaxStages - Math::min(stage, MaxStages));
+            std::memset(m_S1 + stage, 0, count * sizeof(m_S1[0]));
+            std::memset(m_S2 + stage, 0, count * sizeof(m_S2[0]));
+        }
+
+        // ------------------------------------------------
+
+        /**
+         * Process a single sample through all stages.
+         * @param in input type, simd type or float
+         * @param i first lane of the input
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        Type process(Type in, std::size_t i = 0) {
+            for (std::size_t stage = 0; stage < m_Stages; ++stage) {
+                const Type y = load<Type>(m_B0[stage], i) * in + load<Type>(m_S1[stage], i);
+                store(m_S1[stage] + i, load<Type>(m_B1[stage], i) * in - load<Type>(m_A1[stage], i) * y + load<Type>(m_S2[stage], i));
+                store(m_S2[stage] + i, load<Type>(m_B2[stage], i) * in - load<Type>(m_A2[stage], i) * y);
+                in = y;
+            }
+
+            return in;
+        }
+
+        /**
+         * Filter a block in place. Stages are run in groups of 4, each group
+         * over the whole block with its coefficients and state in registers.
+         * @param buffer samples, simd type or float
+         * @param i first lane of the samples
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        void processBlock(std::span<Type> buffer, std::size_t i = 0) {
+            for (std::size_t stage = 0; stage < m_Stages; stage += Group) {
+                switch (Math::min(m_Stages - stage, Group)) {
+                case 1: kernel<1>(buffer, stage, i); break;
+                case 2: kernel<2>(buffer, stage, i); break;
+                case 3: kernel<3>(buffer, stage, i); break;
+                case 4: kernel<4>(buffer, stage, i); break;
+                }
+            }
+        }
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::size_t Group = 4;
+
+        // ------------------------------------------------
+
+        alignas(64) float m_B0[MaxStages][Lanes]{};
+        alignas(64) float m_B1[MaxStages][Lanes]{};
+        alignas(64) float m_B2[MaxStages][Lanes]{};
+        alignas(64) float m_A1[MaxStages][Lanes]{};
+        alignas(64) float m_A2[MaxStages][Lanes]{};
+        alignas(64) float m_S1[MaxStages][Lanes]{};
+        alignas(64) float m_S2[MaxStages][Lanes]{};
+        std::size_t m_Stages = 0;
+
+        // ------------------------------------------------
+
+        template<std::size_t Count, class Type>
+        void kernel(std::span<Type> buffer, std::size_t first, std::size_t i) {
+            Type b0[Count], b1[Count], b2[Count], a1[Count], a2[Count], s1[Count], s2[Count];
+            for (std::size_t k = 0; k < Count; ++k) {
+                b0[k] = load<Type>(m_B0[first + k], i);
+                b1[k] = load<Type>(m_B1[first + k], i);
+                b2[k] = load<Type>(m_B2[first + k], i);
+                a1[k] = load<Type>(m_A1[first + k], i);
+                a2[k] = load<Type>(m_A2[first + k], i);
+                s1[k] = load<Type>(m_S1[first + k], i);
+                s2[k] = load<Type>(m_S2[first + k], i);
+            }
+
+            for (Type& sample : buffer) {
+                Type x = sample;
+                for (std::size_t k = 0; k < Count; ++k) {
+                    const Type y = b0[k] * x + s1[k];
+                    s1[k] = b1[k] * x - a1[k] * y + s2[k];
+                    s2[k] = b2[k] * x - a2[k] * y;
+                    x = y;
+                }
+                sample = x;
+            }
+
+            for (std::size_t k = 0; k < Count; ++k) {
+                store(m_S1[first + k] + i, s1[k]);
+                store(m_S2[first + k] + i, s2[k]);
+            }
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Zero delay feedback state variable filter (topology preserving transform,
+     * Cytomic's form). Unlike a Biquad it stays stable and sounds right when the 
+     * frequency is modulated every sample, and the coefficients only take a 
+     * sin/cos and a division, so they can even be calculated per lane.
+     * 
+     * LowPass4 and HighPass4 are 2 cascaded sections, other types use 1.
+     */
+    template<class MathQuality = Math,
+             std::size_t Parallel = 1,
+             FilterType ...FilterTypes>
+    struct StateVariableFilter {
+
+        // ------------------------------------------------
+
+        struct Coefficients {
+            float k{};      // Damping, 1 / Q
+            float gScale{}; // Frequency warp of the shelves
+            float g{};      // Prewarped frequency
+            float a1{};
+            float a2{};
+            float a3{};
+            float m0{};     // Output mix of input, band and low
+            float m1{};
+            float m2{};
+        };
+
+        // ------------------------------------------------
+
+        struct State {
+            alignas(64) float ic1eq[2][Parallel]{};
+            alignas(64) float ic2eq[2][Parallel]{};
+        };
+
+        // ------------------------------------------------
+
+        constexpr bool quadruple() const { return m_Type == FilterType::LowPass4 || m_Type == FilterType::HighPass4; }
+        constexpr std::size_t passes() const { return quadruple() ? 2 : 1; }
+        constexpr FilterType type() const { return m_Type; }
+        constexpr void sampleRate(float sr) { set(sr, m_SampleRate); }
+        constexpr void gain(float gain) { set(gain, m_Gain); }
+        constexpr void frequency(float frequency) { set(frequency, m_Frequency); }
+        constexpr void resonance(float q) { set(q, m_Q); }
+        constexpr void type(FilterType type) { set(type, m_Type); }
+        constexpr void type(float t) {
+            if constexpr (sizeof...(FilterTypes) == 0) {
+                constexpr FilterType types[]{ 
+                    FilterType::LowPass4, FilterType::LowPass, FilterType::BandPass, 
+                    FilterType::HighPass, FilterType::HighPass4, FilterType::Notch, 
+                    FilterType::AllPass, FilterType::PeakingEQ, FilterType::LowShelf, 
+                    FilterType::HighShelf,
+                };
+                type(types[normalToIndex(t, sizeof(types) / sizeof(FilterType))]);
+            } else {
+                constexpr FilterType types[]{ FilterTypes... };
+                type(types[normalToIndex(t, sizeof...(FilterTypes))]);
+            }
+        }
+
+        // ------------------------------------------------
+
+        bool bypass = false;
+
+        // ------------------------------------------------
+
+        constexpr Coefficients& getCoefficients() {
+            if (dirty) recalculate();
+            return m_Coefficients;
+        }
+
+        constexpr State& getState(std::size_t i) { return m_States[i]; }
+
+        // ------------------------------------------------
+
+        void reset() { std::memset(m_States, 0, sizeof(m_States)); }
+
+        // ------------------------------------------------
+
+        Stereo process(Stereo x) {
+            Stereo result = { processBatch(x.l, 0), processBatch(x.r, 1), };
+            finalizeBatches();
+            return result;
+        }
+
+        /**
+         * Process a single filter batch, used for left/right,
+         * and possible Parallel filters used with SIMD.
+         * @param in input type, can be simd type
+         * @param index use 0 for left, and 1 for right
+         * @param i start at the i'th parallel filter, used with simd
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        Type processBatch(Type in, std::size_t index, std::size_t i = 0) {
+            if (bypass) return in;
+            auto& coeff = getCoefficients();
+            return tick<Type>(in, coeff.a1, coeff.a2, coeff.a3, index, i);
+        }
+
+        /**
+         * Same as above, with a separate frequency for every lane, like 
+         * a cutoff modulated per voice. The other settings are shared.
+         * @param frequency in Hz
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        Type processBatch(Type in, Type frequency, std::size_t index, std::size_t i = 0) {
+            if (bypass) return in;
+            auto& coeff = getCoefficients();
+            const Type normalized = MathQuality::clamp(frequency * (coeff.gScale / m_SampleRate), 0.f, 0.49f);
+            const Type g = MathQuality::nsin(normalized * 0.5f) / MathQuality::ncos(normalized * 0.5f);
+            const Type a1 = 1.f / (1.f + g * (g + coeff.k));
+            const Type a2 = g * a1;
+            return tick<Type>(in, a1, a2, g * a2, index, i);
+        }
+
+        constexpr void finalizeBatches() {} // State is updated in place
+
+        // ------------------------------------------------
+
+    protected:
+        float m_SampleRate = 48000;
+        float m_Frequency = 22000;
+        float m_Gain = 0;
+        float m_Q = 0;
+        FilterType m_Type = FilterType::LowPass;
+        bool dirty = true;
+        Coefficients m_Coefficients;
+        State m_States[2];
+
+        // ------------------------------------------------
+
+        constexpr void set(auto v, auto& me) { if (v != me) { me = v; dirty = true; } }
+
+        // ------------------------------------------------
+
+        template<class Type, class Coefficient>
+        Type tick(Type in, Coefficient a1, Coefficient a2, Coefficient a3, std::size_t index, std::size_t i) {
+            auto& coeff = m_Coefficients;
+            auto& state = m_States[index];
+            for (std::size_t pass = 0; pass < passes(); ++pass) {
+                const Type ic1eq = load<Type>(state.ic1eq[pass], i);
+                const Type ic2eq = load<Type>(state.ic2eq[pass], i);
+                const Type v3 = in - ic2eq;
+                const Type v1 = a1 * ic1eq + a2 * v3;
+                const Type v2 = ic2eq + a2 * ic1eq + a3 * v3;
+                store(state.ic1eq[pass] + i, 2.f * v1 - ic1eq);
+                store(state.ic2eq[pass] + i, 2.f * v2 - ic2eq);
+                in = coeff.m0 * in + coeff.m1 * v1 + coeff.m2 * v2;
+            }
+
+            return in;
+        }
+
+        // ------------------------------------------------
+
+        constexpr void recalculate() {
+            dirty = false;
+            using enum FilterType;
+            auto& coeff = m_Coefficients;
+
+            // Resonance [0, 1] to damping, never 0 so it doesn't self oscillate
+            float k = 2 * (1 - 0.99f * MathQuality::clamp(m_Q, 0.f, 1.f));
+            if (quadruple()) k = Math::min(k * 1.4142f, 2.f); // Keep the 4 pole peak similar
+            const float A = MathQuality::pow(10.f, m_Gain / 40.f);
+
+            coeff.gScale = 1;
+            switch (m_Type) {
+            case LowPass:
+            case LowPass4:  coeff.m0 = 0, coeff.m1 = 0, coeff.m2 = 1; break;
+            case HighPass:
+            case HighPass4: coeff.m0 = 1, coeff.m1 = -k, coeff.m2 = -1; break;
+            case BandPass:  coeff.m0 = 0, coeff.m1 = k, coeff.m2 = 0; break; // Unity gain at the peak
+            case Notch:     coeff.m0 = 1, coeff.m1 = -k, coeff.m2 = 0; break;
+            case AllPass:   coeff.m0 = 1, coeff.m1 = -2 * k, coeff.m2 = 0; break;
+            case PeakingEQ:
+                k /= A;
+                coeff.m0 = 1, coeff.m1 = k * (A * A - 1), coeff.m2 = 0;
+                break;
+            case LowShelf:
+                coeff.gScale = 1 / MathQuality::sqrt(A);
+                coeff.m0 = 1, coeff.m1 = k * (A - 1), coeff.m2 = A * A - 1;
+                break;
+            case HighShelf:
+                coeff.gScale = MathQuality::sqrt(A);
+                coeff.m0 = A * A, coeff.m1 = k * (1 - A) * A, coeff.m2 = 1 - A * A;
+                break;
+            }
+
+            const float normalized = MathQuality::clamp(m_Frequency * coeff.gScale / m_SampleRate, 0.f, 0.49f);
+            coeff.k = k;
+            coeff.g = MathQuality::nsin(normalized * 0.5f) / MathQuality::ncos(normalized * 0.5f);
+            coeff.a1 = 1 / (1 + coeff.g * (coeff.g + k));
+            coeff.a2 = coeff.g * coeff.a1;
+            coeff.a3 = coeff.g * coeff.a2;
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Zero delay feedback 4 pole ladder filter, 4 one pole TPT stages with the 
+     * feedback loop solved instantly, so it stays in tune and stable under 
+     * audio-rate cutoff modulation. With a drive the feedback is saturated, 
+     * which tames the resonance. Resonance 1 is right at self oscillation.
+     * 
+     * Supports LowPass4, LowPass, BandPass, HighPass and HighPass4, 
+     * as mixes of the stage outputs.
+     */
+    template<class MathQuality = Math,
+             std::size_t Parallel = 1,
+             FilterType ...FilterTypes>
+    struct LadderFilter {
+
+        // ------------------------------------------------
+
+        struct Coefficients {
+            float G{}; // One pole gain, g / (1 + g)
+            float k{}; // Feedback
+            std::array<float, 5> mix{}; // Of the input and the 4 stages
+        };
+
+        // ------------------------------------------------
+
+        struct State {
+            alignas(64) float s[4][Parallel]{};
+        };
+
+        // ------------------------------------------------
+
+        constexpr FilterType type() const { return m_Type; }
+        constexpr void sampleRate(float sr) { set(sr, m_SampleRate); }
+        constexpr void frequency(float frequency) { set(frequency, m_Frequency); }
+        constexpr void resonance(float q) { set(q, m_Q); }
+        constexpr void drive(float drive) { set(drive, m_Drive); }
+        constexpr void type(FilterType type) { set(type, m_Type); }
+        constexpr void type(float t) {
+            if constexpr (sizeof...(FilterTypes) == 0) {
+                constexpr FilterType types[]{ 
+                    FilterType::LowPass4, FilterType::LowPass, FilterType::BandPass, 
+                    FilterType::HighPass, FilterType::HighPass4,
+                };
+                type(types[normalToIndex(t, sizeof(types) / sizeof(FilterType))]);
+            } else {
+                constexpr FilterType types[]{ FilterTypes... };
+                type(types[normalToIndex(t, sizeof...(FilterTypes))]);
+            }
+        }
+
+        // ------------------------------------------------
+
+        bool bypass = false;
+
+        // ------------------------------------------------
+
+        constexpr Coefficients& getCoefficients() {
+            if (dirty) recalculate();
+            return m_Coefficients;
+        }
+
+        constexpr State& getState(std::size_t i) { return m_States[i]; }
+
+        // ------------------------------------------------
+
+        void reset() { std::memset(m_States, 0, sizeof(m_States)); }
+
+        // ------------------------------------------------
+
+        Stereo process(Stereo x) {
+            Stereo result = { processBatch(x.l, 0), processBatch(x.r, 1), };
+            finalizeBatches();
+            return result;
+        }
+
+        /**
+         * Process a single filter batch, used for left/right,
+         * and possible Parallel filters used with SIMD.
+         * @param in input type, can be simd type
+         * @param index use 0 for left, and 1 for right
+         * @param i start at the i'th parallel filter, used with simd
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        Type processBatch(Type in, std::size_t index, std::size_t i = 0) {
+            if (bypass) return in;
+            return tick<Type>(in, getCoefficients().G, index, i);
+        }
+
+        /**
+         * Same as above, with a separate frequency for every lane, like 
+         * a cutoff modulated per voice. The other settings are shared.
+         * @param frequency in Hz
+         */
+        template<class Type> requires (is_simd<Type> || is_mono<Type>)
+        Type processBatch(Type in, Type frequency, std::size_t index, std::size_t i = 0) {
+            if (bypass) return in;
+            getCoefficients();
+            const Type normalized = MathQuality::clamp(frequency / m_SampleRate, 0.f, 0.49f);
+            const Type g = MathQuality::nsin(normalized * 0.5f) / MathQuality::ncos(normalized * 0.5f);
+            return tick<Type>(in, g / (1.f + g), index, i);
+        }
+
+        constexpr void finalizeBatches() {} // State is updated in place
+
+        // ------------------------------------------------
+
+    protected:
+        float m_SampleRate = 48000;
+        float m_Frequency = 22000;
+        float m_Q = 0;
+        float m_Drive = 0;
+        FilterType m_Type = FilterType::LowPass4;
+        bool dirty = true;
+        Coefficients m_Coefficients;
+        State m_States[2];
+
+        // ------------------------------------------------
+
+        constexpr void set(auto v, auto& me) { if (v != me) { me = v; dirty = true; } }
+
+        // ------------------------------------------------
+
+        template<class Type, class Gain>
+        Type tick(Type in, Gain G, std::size_t index, std::size_t i) {
+            auto& coeff = m_Coefficients;
+            auto& state = m_States[index];
+
+            // Every stage is y = G * x + (1 - G) * s, so the output of the last
+            // stage is G^4 * u + S, which solves the feedback u = in - k * y4.
+            const Type beta = 1.f - G;
+            const Type s0 = load<Type>(state.s[0], i);
+            const Type s1 = load<Type>(state.s[1], i);
+            const Type s2 = load<Type>(state.s[2], i);
+            const Type s3 = load<Type>(state.s[3], i);
+            const Type G2 = G * G;
+            const Type S = beta * (G2 * G * s0 + G2 * s1 + G * s2 + s3);
+            const Type G4 = G2 * G2;
+
+            Type u = (in - coeff.k * S) / (1.f + coeff.k * G4);
+            if (m_Drive > 0) u = MathQuality::tanh(u * m_Drive) * (1.f / m_Drive);
+
+            const auto stage = [&](Type x, Type s, float* out) {
+                const Type v = G * (x - s);
+                const Type y = v + s;
+                store(out + i, y + v);
+                return y;
+            };
+
+            const Type y1 = stage(u, s0, state.s[0]);
+            const Type y2 = stage(y1, s1, state.s[1]);
+            const Type y3 = stage(y2, s2, state.s[2]);
+            const Type y4 = stage(y3, s3, state.s[3]);
+
+            return coeff.mix[0] * u + coeff.mix[1] * y1 + coeff.mix[2] * y2 + coeff.mix[3] * y3 + coeff.mix[4] * y4;
+        }
+
+        // ------------------------------------------------
+
+        constexpr void recalculate() {
+            dirty = false;
+            using enum FilterType;
+            auto& coeff = m_Coefficients;
+
+            const float normalized = MathQuality::clamp(m_Frequency / m_SampleRate, 0.f, 0.49f);
+            const float g = MathQuality::nsin(normalized * 0.5f) / MathQuality::ncos(normalized * 0.5f);
+            coeff.G = g / (1 + g);
+            coeff.k = 4 * MathQuality::clamp(m_Q, 0.f, 1.f);
+
+            switch (m_Type) {
+            case LowPass:   coeff.mix = { 0, 0, 1, 0, 0 }; break;
+            case BandPass:  coeff.mix = { 0, 0, 4, -8, 4 }; break;
+            case HighPass:  coeff.mix = { 1, -2, 1, 0, 0 }; break;
+            case HighPass4: coeff.mix = { 1, -4, 6, -4, 1 }; break;
+            default:        coeff.mix = { 0, 0, 0, 0, 1 }; break;
+            }
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
     inline float ellipticIntegral(float v) {
         constexpr int M = 4;
         float K = std::numbers::pi / 2;
@@ -825,6 +1463,24 @@ namespace Kaixo::Processing {
             input = { 0, 0 };
         }
 
+        using Module::processBlock;
+
+        /**
+         * Filter a block in place. Runs every filter over the whole block 
+         * before moving on to the next, so the coefficients and state of
+         * a single filter stay in registers.
+         */
+        void processBlock(std::span<Stereo> buffer) {
+            for (auto& filter : *this) {
+                for (auto& sample : buffer) {
+                    sample = filter.process(sample);
+                }
+            }
+
+            if (!buffer.empty()) output = buffer.back();
+            input = { 0, 0 };
+        }
+
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
             for (auto& filter : *this) {
                 filter.sampleRate(sampleRate);
@@ -861,9 +1517,48 @@ namespace Kaixo::Processing {
             for (auto& filter : *this) filter.finalizeBatches();
         }
 
+        /**
+         * Filter a block of one channel in place, with all bands as a single
+         * transposed direct form II cascade. Has its own filter state, so
+         * don't mix it with processBatch on the same index. The coefficients
+         * are taken once per block, call finalizeBlock() after all channels
+         * of the block to advance their interpolation.
+         * @param buffer samples, simd type or float
+         * @param index use 0 for left, and 1 for right
+         * @param i first parallel filter of the samples, used with simd
+         */
+        template<class Type>
+        void processBlock(std::span<Type> buffer, std::size_t index, std::size_t i = 0) {
+            auto& cascade = m_Cascades[index];
+            std::size_t stages = 0;
+            for (std::size_t band = 0; band < N; ++band) {
+                const std::size_t passes = cascade.assign(stages, (*this)[band]);
+
+                // Enabling, bypassing or changing the passes of a band moves the bands 
+                // after it, their sections then hold the state of another filter
+                auto& slots = m_Slots[index][band];
+                if (passes != 0 && (slots.first != stages || slots.passes != passes)) {
+                    cascade.reset(stages, passes);
+                }
+
+                slots = { .first = stages, .passes = passes };
+                stages += passes;
+            }
+
+            cascade.stages(stages);
+            cascade.processBlock(buffer, i);
+        }
+
+        void finalizeBlock(std::size_t samples) {
+            for (auto& filter : *this) filter.finalizeBlock(samples);
+        }
+
         // ------------------------------------------------
 
-        void reset() override { for (auto& filter : *this) filter.reset(); }
+        void reset() override { 
+            for (auto& filter : *this) filter.reset(); 
+            for (auto& cascade : m_Cascades) cascade.reset();
+        }
 
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
             for (auto& filter : *this) {
@@ -873,6 +1568,19 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+    private:
+        struct Slots {
+            std::size_t first = 0;  // First section of the band in the cascade
+            std::size_t passes = 0; // Sections of the band, 0 when bypassed
+        };
+
+        // ------------------------------------------------
+
+        BiquadCascade<Parallel, N * MaxPasses> m_Cascades[2]{};
+        std::array<Slots, N> m_Slots[2]{}; // Layout of the cascades during the last block
+
+        // ------------------------------------------------
+
     };
 
     // Simple specialization for 0 filters, does nothing
@@ -882,7 +1590,11 @@ namespace Kaixo::Processing {
         template<class Type>
         constexpr Type processBatch(Type value, std::size_t, std::size_t = 0) const noexcept { return value; }
 
+        template<class Type>
+        constexpr void processBlock(std::span<Type>, std::size_t, std::size_t = 0) const noexcept {}
+
         constexpr void finalizeBatches() {}
+        constexpr void finalizeBlock(std::size_t) {}
         constexpr void reset() {}
     };
 }
\ No newline at end of file
@@ -14,9 +14,10 @@ namespace Kaixo::Processing {
     /**
      * 
      * Interfaces allow communication between the UI and Processor.
-     * There are 2 types of communication:
+     * There are 3 types of communication:
      *  - Synchronous
      *  - Asynchronous
+     *  - Snapshots
      * 
      * With synchronous communication the execution remains on the UI thread
      * and only data is read from the Processor. With this type of communication
@@ -69,7 +70,31 @@ namespace Kaixo::Processing {
      *       }
      *   };
      * 
-     * This task will then be executed on the audio thread.
+     * This task will then be executed on the audio thread, at the start of the
+     * next block. Tasks are stored inline in a fixed size queue, so captures must
+     * fit in AsyncTaskSize bytes and be trivially destructible (capture pointers
+     * and values, not containers). When the queue is full the task is dropped,
+     * addAsyncTask returns false and the overflow is counted.
+     * 
+     * 
+     * Synchronous interfaces read the Processor while the audio thread is
+     * writing it. When the UI needs a consistent view, use a SnapshotInterface
+     * instead. The audio thread copies the state at the end of every block,
+     * and the UI reads the latest copy without ever waiting on the audio thread:
+     * 
+     *   struct EnvelopeState { float value[3]; };
+     * 
+     *   class EnvelopeInterfaceImpl : public SnapshotInterface<EnvelopeState> {
+     *   public:
+     *       void snapshot(EnvelopeState& state) override {
+     *           for (std::size_t i = 0; i < 3; ++i) 
+     *               state.value[i] = self<Processor>().envelope[i].output;
+     *       }
+     *   };
+     * 
+     * Which is then read in the UI through the state:
+     * 
+     *   float value = settings.interface.state().value[0];
      * 
      */
     class Processor;
@@ -78,34 +103,47 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+        constexpr static std::size_t AsyncTaskSize = 64;      // Bytes available for captures
+        constexpr static std::size_t AsyncTaskCapacity = 256; // Tasks queued between 2 blocks
+
+        using AsyncTask = InlineFunction<void(), AsyncTaskSize>;
+
+        // ------------------------------------------------
+
         virtual ~Interface() = default;
 
         // ------------------------------------------------
 
+        // Tasks dropped because the queue was full, since construction.
+        std::size_t overflows() const { return m_Overflows.load(std::memory_order_relaxed); }
+
+        // ------------------------------------------------
+
     protected:
 
         // ------------------------------------------------
 
-        void addAsyncTask(std::function<void(void)> task) {
-            auto& message = getMessage();
-            message.task = std::move(task);
-            message.executed = false;
+        // Single producer, only call from one thread at a time (usually the UI thread).
+        template<class Fun>
+            requires std::is_trivially_destructible_v<std::decay_t<Fun>>
+        bool addAsyncTask(Fun&& task) {
+            if (m_Tasks.push(AsyncTask{ std::forward<Fun>(task) })) return true;
+            m_Overflows.fetch_add(1, std::memory_order_relaxed);
+            KAIXO_TRACE_INSTANT("Async task overflow");
+            return false;
         }
 
         // ------------------------------------------------
 
+        // Audio thread, runs all queued tasks in the order they were added.
         virtual void execute() {
-            auto end = m_Messages.end();
-            auto it = m_Messages.begin();
-            for (; it != end; ++it) {
-                auto& message = *it;
-                if (!message.executed) {
-                    message.task();
-                    message.executed = true;
-                }
-            }
+            AsyncTask task;
+            while (m_Tasks.pop(task)) task();
         }
 
+        // Audio thread, called at the end of every block.
+        virtual void publish() {}
+
         // ------------------------------------------------
 
         template<std::derived_from<Processor> Ty>
@@ -122,29 +160,61 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
-        struct Message {
-            std::atomic_bool executed = true;
-            std::function<void()> task;
-        };
+        SpscQueue<AsyncTask, AsyncTaskCapacity> m_Tasks{};
+        std::atomic<std::size_t> m_Overflows = 0;
+
+        // ------------------------------------------------
+
+        friend class Processor;
+        friend class ::Kaixo::Controller;
+
+        template<class Ty>
+        friend class InterfaceStorage;
+
+        // ------------------------------------------------
+
+    };
 
-        std::list<Message> m_Messages{};
+    // ------------------------------------------------
+
+    /**
+     * Interface with a State that is published by the audio thread once per
+     * block, through a TripleBuffer. Reading it never blocks and never sees
+     * a half written state, but only one thread may read it (the UI thread).
+     */
+    template<class State>
+    class SnapshotInterface : public Interface {
+    public:
 
         // ------------------------------------------------
 
-        Message& getMessage() {
-            for (auto& message : m_Messages) {
-                if (message.executed) return message;
-            }
-            return m_Messages.emplace_back();
+        // UI thread only, latest published state.
+        const State& state() {
+            m_State.update();
+            return m_State.front();
         }
 
         // ------------------------------------------------
 
-        friend class Processor;
-        friend class ::Kaixo::Controller;
+    protected:
 
-        template<class Ty>
-        friend class InterfaceStorage;
+        // ------------------------------------------------
+
+        // Audio thread, fill the state from the processor. The state is a buffer 
+        // that was published before, so every member has to be written.
+        virtual void snapshot(State& state) = 0;
+
+        // ------------------------------------------------
+
+    private:
+        TripleBuffer<State> m_State{};
+
+        // ------------------------------------------------
+
+        void publish() override {
+            snapshot(m_State.back());
+            m_State.publish();
+        }
 
         // ------------------------------------------------
 
@@ -238,6 +308,13 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
         
+        // Latest state of a SnapshotInterface, does not lock.
+        decltype(auto) state() const requires requires (Type& interface) { interface.state(); } {
+            return m_Interface->state();
+        }
+
+        // ------------------------------------------------
+        
         template<class Fun, class ...Args>
         decltype(auto) call(Fun funptr, Args&& ...args) const {
             std::lock_guard lock{ m_Interface->m_Mutex };
@@ -15,54 +15,134 @@ namespace Kaixo::Processing {
     // ------------------------------------------------
 
 #ifdef KAIXO_INTERNAL_MODULATION
+
+    /**
+     * Compiled modulation routing in compressed sparse row layout. Every row is
+     * a modulated parameter, and its entries are stored contiguously. For every
+     * entry the term is amount * input + bias, where input indexes the values of
+     * the sources followed by their normalized values. Additive rows add their
+     * terms to the parameter value, multiplicative rows multiply by them. Rows
+     * are grouped by the control rate of their parameter.
+     */
+    struct ModulationMatrix {
+
+        // ------------------------------------------------
+
+        constexpr static std::uint32_t NoRow = static_cast<std::uint32_t>(-1);
+
+        enum Flags : std::uint8_t { Multiply = 1, Constrain = 2 };
+
+        struct Group {
+            std::size_t rate;    // Samples between recomputing the rows
+            std::uint32_t first; // First row
+            std::uint32_t last;  // One past the last row
+        };
+
+        // ------------------------------------------------
+
+        std::vector<ParamID> params{};        // Parameter of every row
+        std::vector<std::uint8_t> flags{};    // Flags of every row
+        std::vector<std::uint32_t> offsets{}; // First entry of every row, and one past the last entry
+        std::vector<std::uint32_t> row{};     // Row of every parameter, or NoRow
+        std::vector<Group> groups{};          // Rows with the same control rate, sorted by rate
+
+        std::vector<ModulationSourceID> sources{};
+        std::vector<std::uint32_t> inputs{};
+        std::vector<float> amounts{};
+        std::vector<float> bias{};
+
+        std::uint64_t version = 0; // Changes every time the routing is compiled
+
+        // ------------------------------------------------
+
+        std::size_t rows() const { return params.size(); }
+        std::size_t entries() const { return amounts.size(); }
+
+        bool modulated(ParamID id) const { return id < row.size() && row[id] != NoRow; }
+
+        std::size_t nofLinkedSource(ParamID id) const {
+            return modulated(id) ? offsets[row[id] + 1] - offsets[row[id]] : 0;
+        }
+
+        void foreach(ParamID id, auto fun) const {
+            if (!modulated(id)) return;
+            for (std::uint32_t i = offsets[row[id]]; i < offsets[row[id] + 1]; ++i) {
+                fun(sources[i], amounts[i]);
+            }
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Modulation routing. Edits are made on a small sorted list of routes, after
+     * which the routing is compiled into a ModulationMatrix and published to the
+     * audio thread. Register it with Processor::registerModulation, the controller
+     * then calls update() once per block before processing, so all ParameterDatabases
+     * linked to it read the same matrix(). Only read matrix() on the audio thread.
+     * 
+     * Edits and queries may come from any non-audio thread, they are serialized
+     * with a mutex the audio thread never takes. Use a batch edit for changes 
+     * that should reach the audio thread at once, like a preset morph. The audio
+     * thread queries the routing through matrix().modulated(), nofLinkedSource()
+     * and foreach() instead, which see the routing it is currently using.
+     */
     class ModulationDatabase : public Serializable {
     public:
 
         // ------------------------------------------------
-        
+
         constexpr static std::size_t Parameters = nofParameters();
         constexpr static std::size_t Sources = nofSources();
 
         // ------------------------------------------------
 
-        void set(ParamID id, ModulationSourceID source, float amount) {
-            bool shouldRemove = amount == 0;
-            for (std::size_t i = 0; i < m_Modulations[id].size(); ++i) {
-                if (m_Modulations[id][i].source == source) {
-                    if (shouldRemove) {
-                        m_Modulations[id].erase_index(i);
-                    } else {
-                        m_Modulations[id][i].amount = amount;
-                    }
-                    return;
-                }
-            }
+        struct Route {
+            ParamID param;
+            ModulationSourceID source;
+            float amount; // 0 removes the route
+        };
 
-            if (!shouldRemove) {
-                m_Modulations[id].emplace_back(source, amount);
-            }
-        }
+        // ------------------------------------------------
 
-        float get(ParamID id, ModulationSourceID source) const {
-            for (std::size_t i = 0; i < m_Modulations[id].size(); ++i) {
-                if (m_Modulations[id][i].source == source) {
-                    return m_Modulations[id][i].amount;
-                }
-            }
+        // Not realtime safe, locks the routing. Never call from the audio thread.
+        void set(ParamID id, ModulationSourceID source, float amount);
+        float get(ParamID id, ModulationSourceID source) const;
 
-            return 0;
-        }
+        // Apply all edits, the audio thread sees either none or all of them.
+        void set(std::span<const Route> routes);
+
+        // Replace the complete routing with the given routes.
+        void assign(std::span<const Route> routes);
 
         // ------------------------------------------------
-        
-        constexpr void foreach(ParamID id, auto fun) const {
-            for (auto& [source, mod] : m_Modulations[id]) fun(source, mod);
+
+        // Not realtime safe, locks the routing, use matrix().foreach() on the audio thread.
+        // The function is called while the routing is locked, it may not edit the routing.
+        void foreach(ParamID id, auto fun) const {
+            std::lock_guard lock{ m_Mutex };
+            for (auto it = first(id); it != m_Routes.end() && it->param == id; ++it) {
+                fun(it->source, it->amount);
+            }
         }
 
         // ------------------------------------------------
-        
-        constexpr bool modulated(ParamID id) const { return m_Modulations[id].size() != 0; }
-        constexpr std::size_t nofLinkedSource(ParamID id) const { return m_Modulations[id].size(); }
+
+        // Not realtime safe, locks the routing, use the same queries on matrix() on the audio thread.
+        bool modulated(ParamID id) const { return nofLinkedSource(id) != 0; }
+        std::size_t nofLinkedSource(ParamID id) const;
+
+        // ------------------------------------------------
+
+        // Audio thread only, switch to the latest routing. Must have a single caller,
+        // matrix() stays valid until the next call.
+        bool update() { return m_Matrix.update(); }
+
+        // Audio thread only, routing that is currently in use.
+        const ModulationMatrix& matrix() const { return m_Matrix.front(); }
 
         // ------------------------------------------------
 
@@ -73,12 +153,17 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
     private:
-        struct Entry {
-            ModulationSourceID source;
-            float amount;
-        };
+        mutable std::mutex m_Mutex{};
+        std::vector<Route> m_Routes{}; // Sorted by parameter, then source
+        TripleBuffer<ModulationMatrix> m_Matrix{};
+        std::uint64_t m_Version = 0;
+
+        // ------------------------------------------------
+
+        std::vector<Route>::const_iterator first(ParamID id) const;
 
-        std::array<Vector<Entry, Sources>, Parameters> m_Modulations{};
+        void apply(const Route& route);
+        void compile();
 
         // ------------------------------------------------
 
@@ -87,4 +172,4 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Kaixo/Core/Definitions.hpp"
 #include "Kaixo/Core/Processing/Buffer.hpp"
+#include "Kaixo/Core/Processing/Profiler.hpp"
 
 // ------------------------------------------------
 
@@ -22,11 +23,30 @@ namespace Kaixo::Processing {
         virtual void reset() {};
         virtual bool active() const { return false; }
 
+        // Latency this module adds, in samples at the rate it was prepared at.
+        virtual double latency() const { return 0; }
+
+        // ------------------------------------------------
+
+        /**
+         * Process multiple samples at once. By default this calls process() 
+         * for every sample, modules can override it with a native block 
+         * implementation that avoids the per-sample virtual call and state
+         * dispatch. Modules that generate output also provide a processBlock
+         * overload that writes every sample into a span.
+         * @param samples amount of samples to process
+         */
+        virtual void processBlock(std::size_t samples) {
+            for (std::size_t i = 0; i < samples; ++i) process();
+        }
+
         // ------------------------------------------------
         
         Buffer& outputBuffer() const;
         const Buffer& inputBuffer() const;
 
+        // Multiplies the rate of every module, not only this one. Use Oversampled instead.
+        [[deprecated("Oversamples every module, run the modules in an Oversampled container instead")]]
         void oversample(std::size_t n) const;
 
         bool offline() const;
@@ -39,11 +59,25 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+#ifdef KAIXO_PROFILE_MODULES
+        // Time this module until the end of the scope.
+        Profiler::Scope profile() const { return { m_Profiler, m_ProfileNode }; }
+        Profiler* profiler() const { return m_Profiler; }
+#endif
+
+        // ------------------------------------------------
+
     private:
 
         // ------------------------------------------------
 
         Controller* m_Controller;
+        std::size_t m_Oversample = 1; // Set by the parents that oversample, see Oversampled
+
+#ifdef KAIXO_PROFILE_MODULES
+        Profiler* m_Profiler = nullptr;
+        std::uint32_t m_ProfileNode = Profiler::NoNode;
+#endif
 
         // ------------------------------------------------
 
@@ -78,7 +112,12 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
-        virtual void process() override {};
+        // Run the registered modules in the order they were registered, a block at a time
+        // through their processBlock. Containers that override process() with their own 
+        // processing must override processBlock as well.
+        virtual void process() override;
+        virtual void processBlock(std::size_t samples) override;
+
         virtual void prepare(double sampleRate, std::size_t maxBufferSize) override;
         virtual void reset() override;
 
@@ -86,6 +125,9 @@ namespace Kaixo::Processing {
         
         virtual bool active() const override;
 
+        // Assumes the modules run in parallel, containers that chain them should override this.
+        virtual double latency() const override;
+
         // ------------------------------------------------
 
         virtual void param(ParamID id, ParamValue value) override;
@@ -97,6 +139,13 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+    protected:
+
+        // Rate the modules run at, relative to this container.
+        virtual std::size_t modulesOversample() const { return 1; }
+
+        // ------------------------------------------------
+
     private:
         std::vector<Module*> m_Modules{};
         std::vector<ParameterListener*> m_Listeners{};
@@ -0,0 +1,231 @@
+#pragma once
+#include "Kaixo/Core/Definitions.hpp"
+#include "Kaixo/Core/Processing/Module.hpp"
+#include "Kaixo/Core/Processing/Modules/Envelope.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    /**
+     * Same envelope as Envelope, but for Lanes voices at once, with the state
+     * stored as structure of arrays so it can be processed with simd types.
+     * Every segment is a curve from one value to another, so the per-sample
+     * work is the same for every lane. Segment transitions are handled per lane,
+     * but only when the lane that ends its segment first actually does so.
+     */
+    template<std::size_t Lanes>
+    class BatchEnvelope : public Module {
+    public:
+
+        // ------------------------------------------------
+
+        using State = Envelope::State;
+        using Mode = Envelope::Mode;
+
+        // ------------------------------------------------
+
+        alignas(64) float output[Lanes]{};
+
+        // ------------------------------------------------
+
+        void delay(float millis) { m_DelayMillis = millis; }
+        void attack(float millis) { m_AttackMillis = millis; }
+        void decay(float millis) { m_DecayMillis = millis; }
+        void release(float millis) { m_ReleaseMillis = millis; }
+
+        void attackLevel(float level) { m_AttackLevel = level; }
+        void decayLevel(float level) { m_DecayLevel = level; }
+        void sustain(float level) {
+            m_Sustain = level;
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                if (m_State[lane] == State::Decay) m_To[lane] = m_Sustain;
+                if (m_State[lane] == State::Sustain) m_From[lane] = m_To[lane] = m_Sustain;
+            }
+        }
+
+        void attackCurve(float curve) { m_AttackCurve = curve; }
+        void decayCurve(float curve) { m_DecayCurve = curve; }
+        void releaseCurve(float curve) { m_ReleaseCurve = curve; }
+
+        void mode(Mode mode) { m_Mode = mode; }
+
+        // ------------------------------------------------
+
+        bool idle(std::size_t lane) const { return m_State[lane] == State::Idle; }
+        bool active() const override {
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                if (!idle(lane)) return true;
+            }
+            return false;
+        }
+
+        // ------------------------------------------------
+
+        void gate(std::size_t lane, bool gate, bool retrigger = false) {
+            if (gate) trigger(lane, retrigger);
+            else release(lane);
+        }
+
+        void release(std::size_t lane) {
+            if (m_State[lane] != State::Idle) {
+                segment(lane, State::Release, output[lane]);
+            }
+        }
+
+        void trigger(std::size_t lane, bool retrigger = false) {
+            if (retrigger && !idle(lane)) {
+                segment(lane, State::Attack, output[lane]);
+            } else {
+                // Special case when no delay and no attack, immediate
+                // set it to the decay value.
+                if (m_DelayMillis <= 1 && m_AttackMillis <= 1) {
+                    segment(lane, State::Decay);
+                } else {
+                    segment(lane, State::Delay, m_AttackLevel);
+                }
+            }
+        }
+
+        // ------------------------------------------------
+
+        /**
+         * Process a single sample for all lanes.
+         * @tparam SimdType simd type that holds Lanes floats
+         * @return the output of all lanes
+         */
+        template<is_simd SimdType>
+            requires (sizeof(SimdType) / sizeof(float) == Lanes)
+        SimdType process() {
+            if (m_SamplesUntilTransition == 0) transition();
+            --m_SamplesUntilTransition;
+
+            const SimdType phase = load<SimdType>(m_Phase, 0) + load<SimdType>(m_Delta, 0);
+            const SimdType from = load<SimdType>(m_From, 0);
+            const SimdType to = load<SimdType>(m_To, 0);
+            const SimdType clamped = Math::Fast::min(phase, SimdType(1.f));
+            const SimdType result = from + (to - from) * Math::Fast::curve(clamped, load<SimdType>(m_Curve, 0));
+
+            store(m_Phase, phase);
+            store(output, result);
+            return result;
+        }
+
+        void process() override {
+            if (m_SamplesUntilTransition == 0) transition();
+            --m_SamplesUntilTransition;
+
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                m_Phase[lane] += m_Delta[lane];
+                const float clamped = Math::Fast::min(m_Phase[lane], 1.f);
+                output[lane] = m_From[lane] + (m_To[lane] - m_From[lane]) * Math::Fast::curve(clamped, m_Curve[lane]);
+            }
+        }
+
+        void reset() override {
+            Module::reset();
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                segment(lane, State::Idle);
+                output[lane] = 0;
+            }
+        }
+
+        // ------------------------------------------------
+
+    private:
+        Mode m_Mode = Mode::Normal;
+
+        float m_DelayMillis = 0;
+        float m_AttackMillis = 1;
+        float m_DecayMillis = 60;
+        float m_ReleaseMillis = 50;
+
+        float m_AttackLevel = 0;
+        float m_DecayLevel = 1;
+        float m_Sustain = 0.5;
+
+        float m_AttackCurve = 0;
+        float m_DecayCurve = 0;
+        float m_ReleaseCurve = 0;
+
+        // ------------------------------------------------
+
+        State m_State[Lanes]{};
+        alignas(64) float m_Phase[Lanes]{};
+        alignas(64) float m_Delta[Lanes]{}; // Phase increment per sample, 0 when the segment has no end
+        alignas(64) float m_From[Lanes]{};
+        alignas(64) float m_To[Lanes]{};
+        alignas(64) float m_Curve[Lanes]{};
+
+        std::size_t m_SamplesUntilTransition = 0;
+
+        // ------------------------------------------------
+
+        float samples(float millis) const { return 0.001 * millis * sampleRate(); }
+
+        // ------------------------------------------------
+
+        void segment(std::size_t lane, State state, float from = 0) {
+            auto set = [&](float duration, float a, float b, float curve) {
+                m_Phase[lane] = 0;
+                m_Delta[lane] = duration <= 0 ? 1 : 1 / duration;
+                m_From[lane] = a;
+                m_To[lane] = b;
+                m_Curve[lane] = curve;
+            };
+
+            m_State[lane] = state;
+            switch (state) {
+            case State::Delay:   set(samples(m_DelayMillis), from, from, 0); break;
+            case State::Attack:  set(samples(m_AttackMillis), from, m_DecayLevel, m_AttackCurve); break;
+            case State::Decay:   set(samples(m_DecayMillis), m_DecayLevel, m_Sustain, m_DecayCurve); break;
+            case State::Release: set(samples(m_ReleaseMillis), from, 0, m_ReleaseCurve); break;
+            case State::Sustain: set(0, m_Sustain, m_Sustain, 0), m_Delta[lane] = 0; break;
+            default:             set(0, 0, 0, 0), m_Delta[lane] = 0; break;
+            }
+
+            // Recalculate when the next transition happens
+            m_SamplesUntilTransition = 0;
+        }
+
+        // Moves the lanes that finished their segment to their next
+        // segment, and calculates when the next transition will happen.
+        void transition() {
+            std::size_t next = std::numeric_limits<std::size_t>::max();
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                if (m_Delta[lane] == 0) continue;
+
+                if (m_Phase[lane] >= 1) {
+                    switch (m_State[lane]) {
+                    case State::Delay: segment(lane, State::Attack, m_From[lane]); break;
+                    case State::Attack: segment(lane, State::Decay); break;
+                    case State::Decay:
+                        switch (m_Mode) {
+                        case Mode::Trigger: segment(lane, State::Release, m_Sustain); break;
+                        case Mode::Loop:    segment(lane, State::Attack, m_AttackLevel); break;
+                        default:            segment(lane, State::Sustain); break;
+                        }
+                        break;
+                    case State::Release: segment(lane, State::Idle); break;
+                    default: break; // Idle and Sustain have no end
+                    }
+                }
+
+                if (m_Delta[lane] == 0) continue;
+
+                const float remaining = Math::ceil((1 - m_Phase[lane]) / m_Delta[lane]);
+                next = Math::min(next, static_cast<std::size_t>(Math::max(remaining, 1.f)));
+            }
+
+            m_SamplesUntilTransition = next;
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
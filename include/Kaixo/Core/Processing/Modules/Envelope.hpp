@@ -109,55 +109,40 @@ namespace Kaixo::Processing {
             case State::Sustain: output = m_Sustain; break;
             case State::Delay:
                 m_Phase += 1 / m_Delay;
-                if (m_Phase >= 1.0) {
-                    output = m_AttackValue;
-                    m_Phase = 0;
-                    m_State = State::Attack;
-                }
-                else {
-                    output = m_AttackValue;
-                }
+                if (m_Phase >= 1.0) nextSegment();
+                else output = m_AttackValue;
                 break;
             case State::Attack:
                 m_Phase += 1 / m_Attack;
-                if (m_Phase >= 1.0) {
-                    output = m_DecayLevel;
-                    m_Phase = 0;
-                    m_State = State::Decay;
-                }
-                else {
-                    output = m_AttackValue + (m_DecayLevel - m_AttackValue) * Math::Fast::curve(m_Phase, m_AttackCurve);
-                }
+                if (m_Phase >= 1.0) nextSegment();
+                else output = attackAt(m_Phase);
                 break;
             case State::Decay:
                 m_Phase += 1 / m_Decay;
-                if (m_Phase >= 1.0) {
-                    output = m_Sustain;
-                    m_Phase = 0;
-                    switch (m_Mode) {
-                    case Mode::Trigger: m_State = State::Release; break;
-                    case Mode::Loop:    m_State = State::Attack;  break;
-                    default:            m_State = State::Sustain; break;
-                    }
-                }
-                else {
-                    output = m_DecayLevel - (m_DecayLevel - m_Sustain) * Math::Fast::curve(m_Phase, m_DecayCurve);
-                }
+                if (m_Phase >= 1.0) nextSegment();
+                else output = decayAt(m_Phase);
                 break;
             case State::Release:
                 m_Phase += 1 / m_Release;
-                if (m_Phase >= 1.0) {
-                    output = 0;
-                    m_Phase = 0;
-                    m_State = State::Idle;
-                }
-                else {
-                    output = m_ReleaseValue - m_ReleaseValue * Math::Fast::curve(m_Phase, m_ReleaseCurve);
-                }
+                if (m_Phase >= 1.0) nextSegment();
+                else output = releaseAt(m_Phase);
                 break;
             }
         }
 
+        void processBlock(std::size_t samples) override {
+            generate(samples, [](std::size_t, float) {});
+        }
+
+        /**
+         * Generate a block of envelope output. Same result as calling process()
+         * for every sample, but the state is only dispatched once per segment.
+         * @param out output, one value per sample
+         */
+        void processBlock(std::span<float> out) {
+            generate(out.size(), [&](std::size_t i, float value) { out[i] = value; });
+        }
+
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
             Module::prepare(sampleRate, maxBufferSize);
 
@@ -218,6 +203,76 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
         
+        float attackAt(float phase) const { return m_AttackValue + (m_DecayLevel - m_AttackValue) * Math::Fast::curve(phase, m_AttackCurve); }
+        float decayAt(float phase) const { return m_DecayLevel - (m_DecayLevel - m_Sustain) * Math::Fast::curve(phase, m_DecayCurve); }
+        float releaseAt(float phase) const { return m_ReleaseValue - m_ReleaseValue * Math::Fast::curve(phase, m_ReleaseCurve); }
+
+        // Called when the phase of the current segment reaches 1
+        void nextSegment() {
+            m_Phase = 0;
+            switch (m_State) {
+            case State::Delay:
+                output = m_AttackValue;
+                m_State = State::Attack;
+                break;
+            case State::Attack:
+                output = m_DecayLevel;
+                m_State = State::Decay;
+                break;
+            case State::Decay:
+                output = m_Sustain;
+                switch (m_Mode) {
+                case Mode::Trigger: m_State = State::Release; break;
+                case Mode::Loop:    m_State = State::Attack;  break;
+                default:            m_State = State::Sustain; break;
+                }
+                break;
+            case State::Release:
+                output = 0;
+                m_State = State::Idle;
+                break;
+            }
+        }
+
+        // ------------------------------------------------
+
+        template<class Write>
+        void generate(std::size_t samples, Write write) {
+            // Runs the current segment until its phase reaches 1, 
+            // or the block ends. Returns the index it stopped at.
+            auto segment = [&](std::size_t i, float length, auto at) {
+                const float delta = 1 / length;
+                for (; i < samples; ++i) {
+                    m_Phase += delta;
+                    if (m_Phase >= 1.0) return i;
+                    write(i, output = at(m_Phase));
+                }
+                return i;
+            };
+
+            std::size_t i = 0;
+            while (i < samples) {
+                switch (m_State) {
+                case State::Idle: 
+                case State::Sustain:
+                    output = m_State == State::Idle ? 0 : m_Sustain;
+                    for (; i < samples; ++i) write(i, output);
+                    return;
+                case State::Delay:   i = segment(i, m_Delay, [&](float) { return m_AttackValue; }); break;
+                case State::Attack:  i = segment(i, m_Attack, [&](float phase) { return attackAt(phase); }); break;
+                case State::Decay:   i = segment(i, m_Decay, [&](float phase) { return decayAt(phase); }); break;
+                case State::Release: i = segment(i, m_Release, [&](float phase) { return releaseAt(phase); }); break;
+                }
+
+                if (i < samples) {
+                    nextSegment();
+                    write(i++, output);
+                }
+            }
+        }
+
+        // ------------------------------------------------
+
         void updateDelay()   { m_Delay   = 0.001 * m_DelayMillis   * sampleRate(); }
         void updateAttack()  { m_Attack  = 0.001 * m_AttackMillis  * sampleRate(); }
         void updateDecay()   { m_Decay   = 0.001 * m_DecayMillis   * sampleRate(); }
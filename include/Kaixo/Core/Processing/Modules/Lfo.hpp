@@ -80,58 +80,20 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
         void process() override {
-            // When frozen, always at phaseOffset
-            if (m_Tempo == Tempo::Freeze && m_Sync == Sync::Tempo) {
-                m_Phase = m_PhaseOffset;
-                output = at(m_Phase);
-                return;
-            }
-
-            output = at(m_Phase);
+            generate(1, [](std::size_t, float) {});
+        }
 
-            float deltaPhase = 1. / samplesPerOscillation();
+        void processBlock(std::size_t samples) override {
+            generate(samples, [](std::size_t, float) {});
+        }
 
-            switch (m_Mode) {
-            case Mode::Sync:
-                m_Phase = m_PhaseIncremented = Math::Fast::fmod1(m_PhaseIncremented + deltaPhase);
-                break;
-            case Mode::Trigger:
-                m_Phase = m_PhaseIncremented = Math::Fast::fmod1(m_PhaseIncremented + deltaPhase);
-                break;
-            case Mode::Envelope:
-                m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0);
-                break;
-            case Mode::Sustain:
-                if (m_Gate) {
-                    m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, m_PhaseOffset);
-                } else {
-                    m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0);
-                }
-                break;
-            case Mode::LoopPoint:
-                if (m_FirstPhase) {
-                    float p = m_PhaseIncremented + deltaPhase;
-                    if (p >= 1) m_FirstPhase = false;
-                    m_Phase = m_PhaseIncremented = Math::Fast::fmod1(p);
-                } else if (m_PhaseOffset < 1) {
-                    m_PhaseIncremented = Math::Fast::fmod(m_PhaseIncremented + deltaPhase, 1.0 - m_PhaseOffset);
-                    m_Phase = m_PhaseIncremented + m_PhaseOffset;
-                } else {
-                    m_Phase = 1;
-                }
-                break;
-            case Mode::LoopHold:
-                if (m_Gate) {
-                    if (m_PhaseOffset > 0) {
-                        m_Phase = m_PhaseIncremented = Math::Fast::fmod(m_PhaseIncremented + deltaPhase, m_PhaseOffset);
-                    } else {
-                        m_Phase = 0;
-                    }
-                } else {
-                    m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0);
-                }
-                break;
-            }
+        /**
+         * Generate a block of lfo output. The oscillation speed is 
+         * calculated once per block instead of once per sample.
+         * @param out output, one value per sample
+         */
+        void processBlock(std::span<float> out) {
+            generate(out.size(), [&](std::size_t i, float value) { out[i] = value; });
         }
 
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
@@ -192,6 +154,76 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
         
+        template<class Write>
+        void generate(std::size_t samples, Write write) {
+            // When frozen, always at phaseOffset
+            if (m_Tempo == Tempo::Freeze && m_Sync == Sync::Tempo) {
+                m_Phase = m_PhaseOffset;
+                output = at(m_Phase);
+                for (std::size_t i = 0; i < samples; ++i) write(i, output);
+                return;
+            }
+
+            const float deltaPhase = 1. / samplesPerOscillation();
+
+            // Mode is dispatched once, the step is inlined in the loop
+            auto loop = [&](auto step) {
+                for (std::size_t i = 0; i < samples; ++i) {
+                    output = at(m_Phase);
+                    write(i, output);
+                    step();
+                }
+            };
+
+            switch (m_Mode) {
+            case Mode::Sync:
+            case Mode::Trigger:
+                loop([&] { m_Phase = m_PhaseIncremented = Math::Fast::fmod1(m_PhaseIncremented + deltaPhase); });
+                break;
+            case Mode::Envelope:
+                loop([&] { m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0); });
+                break;
+            case Mode::Sustain:
+                loop([&] { 
+                    if (m_Gate) {
+                        m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, m_PhaseOffset);
+                    } else {
+                        m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0);
+                    }
+                });
+                break;
+            case Mode::LoopPoint:
+                loop([&] {
+                    if (m_FirstPhase) {
+                        float p = m_PhaseIncremented + deltaPhase;
+                        if (p >= 1) m_FirstPhase = false;
+                        m_Phase = m_PhaseIncremented = Math::Fast::fmod1(p);
+                    } else if (m_PhaseOffset < 1) {
+                        m_PhaseIncremented = Math::Fast::fmod(m_PhaseIncremented + deltaPhase, 1.0 - m_PhaseOffset);
+                        m_Phase = m_PhaseIncremented + m_PhaseOffset;
+                    } else {
+                        m_Phase = 1;
+                    }
+                });
+                break;
+            case Mode::LoopHold:
+                loop([&] {
+                    if (m_Gate) {
+                        if (m_PhaseOffset > 0) {
+                            m_Phase = m_PhaseIncremented = Math::Fast::fmod(m_PhaseIncremented + deltaPhase, m_PhaseOffset);
+                        } else {
+                            m_Phase = 0;
+                        }
+                    } else {
+                        m_Phase = m_PhaseIncremented = Math::Fast::min(m_PhaseIncremented + deltaPhase, 1.0);
+                    }
+                });
+                break;
+            }
+        }
+
+        // ------------------------------------------------
+        
         float at(float x) {
             if (m_Storage) return m_Storage->at(x) * m_Mix + (1 - m_Mix) * 0.5;
             else return 0;
@@ -0,0 +1,269 @@
+#pragma once
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Definitions.hpp"
+#include "Kaixo/Core/Processing/Buffer.hpp"
+#include "Kaixo/Core/Processing/Module.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    /**
+     * One 2x stage of polyphase allpass IIR halfband filtering (two paths of
+     * first order allpass sections, coefficients designed after Laurent de
+     * Soras' HIIR). Low latency, but the phase is not linear. The left and
+     * right channel of both paths are processed as 4 lanes, so every section
+     * is a single vector operation. An instance either upsamples or
+     * downsamples, it keeps the state of one direction.
+     */
+    class HalfbandIir {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t MaxCoefficients = 12;
+
+        // ------------------------------------------------
+
+        /**
+         * Not realtime safe.
+         * @param coefficients amount of allpass sections, even, at most MaxCoefficients
+         * @param transition transition bandwidth, relative to the low sample rate
+         */
+        void design(std::size_t coefficients, double transition);
+        void reset();
+
+        // Group delay at DC, in samples at the high sample rate.
+        double delay() const { return m_Delay; }
+
+        // ------------------------------------------------
+
+        // Out holds 2 * samples.
+        void upsample(const Stereo* in, Stereo* out, std::size_t samples);
+
+        // In holds 2 * samples.
+        void downsample(const Stereo* in, Stereo* out, std::size_t samples);
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::size_t MaxSections = MaxCoefficients / 2;
+
+        // ------------------------------------------------
+
+        // Lanes are { path 0 left, path 0 right, path 1 left, path 1 right }
+        alignas(16) float m_Coefficients[MaxSections][4]{};
+        alignas(16) float m_X[MaxSections][4]{};
+        alignas(16) float m_Y[MaxSections][4]{};
+        std::size_t m_Sections = 0;
+        double m_Delay = 0;
+
+        // ------------------------------------------------
+
+        void section(float(&lanes)[4]);
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * One 2x stage of linear phase FIR halfband filtering, Kaiser windowed
+     * sinc. Every other tap of a halfband filter is zero, so each output
+     * sample is one dot product over the non-zero taps, and the centre tap is
+     * a plain delay. The history is stored twice, interleaved left/right, so
+     * the dot product always reads one contiguous window and vectorizes.
+     */
+    class HalfbandFir {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t MaxTaps = 32; // Non-zero taps, excluding the centre
+
+        // ------------------------------------------------
+
+        /**
+         * Not realtime safe.
+         * @param taps amount of non-zero taps excluding the centre, multiple of 4, at most MaxTaps
+         * @param beta Kaiser window shape, higher trades transition width for attenuation
+         */
+        void design(std::size_t taps, double beta);
+        void reset();
+
+        // Latency in samples at the high sample rate.
+        double delay() const { return static_cast<double>(m_Taps - 1); }
+
+        // ------------------------------------------------
+
+        // Out holds 2 * samples.
+        void upsample(const Stereo* in, Stereo* out, std::size_t samples);
+
+        // In holds 2 * samples.
+        void downsample(const Stereo* in, Stereo* out, std::size_t samples);
+
+        // ------------------------------------------------
+
+    private:
+        struct History {
+            alignas(16) float data[4 * MaxTaps]{}; // 2 copies of the taps, stereo interleaved
+            std::size_t write = 0;
+
+            // Window of the last 'taps' samples, oldest first.
+            const float* push(Stereo value, std::size_t taps);
+        };
+
+        // ------------------------------------------------
+
+        alignas(16) float m_Coefficients[2 * MaxTaps]{}; // Every tap twice, for left and right
+        History m_History[2]{}; // Downsampling keeps the even samples in the second one
+        std::size_t m_Taps = 0;
+
+        // ------------------------------------------------
+
+        Stereo convolve(const float* window) const;
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Block based 2x, 4x, 8x or 16x oversampling, by cascading halfband
+     * stages. The first stage has the steepest filters, later stages only
+     * need to reject what is left above the original Nyquist frequency, so
+     * they are a lot cheaper. Upsampling returns the internal high rate
+     * buffer, process it in place and downsample it back.
+     */
+    class Oversampler {
+    public:
+
+        // ------------------------------------------------
+
+        enum class Phase {
+            Linear,  // FIR halfbands, no phase distortion, more latency
+            Minimum, // IIR halfbands, only a few samples of latency
+        };
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t MaxStages = 4;
+
+        // ------------------------------------------------
+
+        // Not realtime safe, both take effect on the next prepare.
+        void factor(std::size_t n);
+        void phase(Phase phase) { m_NextPhase = phase; }
+
+        // Active since the last prepare.
+        std::size_t factor() const { return std::size_t{ 1 } << m_Stages; }
+        Phase phase() const { return m_Phase; }
+
+        // ------------------------------------------------
+
+        // Not realtime safe, allocates the buffers and designs the filters.
+        void prepare(std::size_t maxBufferSize);
+        void reset();
+
+        // Round trip latency, in samples at the original sample rate.
+        double latency() const;
+
+        // ------------------------------------------------
+
+        // Upsamples into the internal buffer, and returns it.
+        std::span<Stereo> upsample(std::span<const Stereo> in);
+
+        // Internal buffer for 'samples' original samples, without upsampling anything into it.
+        std::span<Stereo> buffer(std::size_t samples);
+
+        // Downsamples the internal buffer into out.
+        void downsample(std::span<Stereo> out);
+
+        // ------------------------------------------------
+
+    private:
+        std::size_t m_Stages = 0; // Active, since the last prepare
+        std::size_t m_NextStages = 0;
+        Phase m_Phase = Phase::Minimum;
+        Phase m_NextPhase = Phase::Minimum;
+
+        HalfbandIir m_IirUp[MaxStages]{};
+        HalfbandIir m_IirDown[MaxStages]{};
+        HalfbandFir m_FirUp[MaxStages]{};
+        HalfbandFir m_FirDown[MaxStages]{};
+
+        Buffer m_Buffers[2]{}; // Ping-pong at the highest rate
+        std::size_t m_Current = 0; // Buffer holding the high rate signal
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Runs a subgraph at a multiple of the sample rate. Registered modules
+     * are prepared at the oversampled rate and buffer size, and their
+     * sampleRate() includes the factor. Use process() for effects and
+     * generate() for sources, inside the callback run the children on the
+     * high rate span.
+     */
+    class Oversampled : public ModuleContainer {
+    public:
+
+        // ------------------------------------------------
+
+        // Not realtime safe, both take effect on the next prepare.
+        void factor(std::size_t n) { m_Oversampler.factor(n); }
+        void phase(Oversampler::Phase phase) { m_Oversampler.phase(phase); }
+
+        std::size_t factor() const { return m_Oversampler.factor(); }
+
+        // ------------------------------------------------
+
+        void prepare(double sampleRate, std::size_t maxBufferSize) override;
+        void reset() override;
+
+        double latency() const override;
+
+        // ------------------------------------------------
+
+        // Upsamples the block, calls fun with the high rate span, and downsamples the result back into the block.
+        template<std::invocable<std::span<Stereo>> Fun>
+        void process(std::span<Stereo> block, Fun&& fun) {
+            fun(m_Oversampler.upsample(block));
+            m_Oversampler.downsample(block);
+        }
+
+        // Calls fun with a silent high rate span to generate into, and downsamples the result into the block.
+        template<std::invocable<std::span<Stereo>> Fun>
+        void generate(std::span<Stereo> block, Fun&& fun) {
+            auto buffer = m_Oversampler.buffer(block.size());
+            std::ranges::fill(buffer, Stereo{ 0, 0 });
+            fun(buffer);
+            m_Oversampler.downsample(block);
+        }
+
+        // ------------------------------------------------
+
+    protected:
+        std::size_t modulesOversample() const override { return m_Oversampler.factor(); }
+
+        // ------------------------------------------------
+
+    private:
+        Oversampler m_Oversampler{};
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
@@ -26,81 +26,161 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
         constexpr static std::size_t Parameters = nofParameters();
-        struct Param {
-            ParamValue add{};
-            ParamValue goal{};
-            ParamValue value{};
-            ParamValue access{};
+        constexpr static std::size_t Lanes = std::max(nofSmoothedParameters(), std::size_t{ 1 });
+        constexpr static std::size_t NoLane = static_cast<std::size_t>(-1);
+
+        // Parameters that are ramping are packed at the start of these arrays,
+        // so advancing all of them is a single loop the compiler can vectorize.
+        struct Ramps {
+            alignas(64) std::array<ParamValue, Lanes> value{};
+            alignas(64) std::array<ParamValue, Lanes> add{};
+            std::array<ParamValue, Lanes> target{};     // Value at the end of the current segment
+            std::array<std::size_t, Lanes> remaining{}; // Samples left in the current segment
+            std::array<ParamID, Lanes> id{};
+            std::size_t size = 0;
         };
 
         // ------------------------------------------------
         
         ParameterDatabase(Self* self) 
             : m_Self(self) 
-        {}
+        {
+#ifdef KAIXO_INTERNAL_MODULATION
+            for (ModulationSourceID id = 0; id < Sources; ++id) {
+                m_SourceRate[id] = Math::max(modulationSource(id).controlRate, std::size_t{ 1 });
+                m_InterpolateSources |= m_SourceRate[id] != 1;
+            }
+#endif
+        }
 
         // ------------------------------------------------
 
 #ifdef KAIXO_INTERNAL_MODULATION
+        // Many databases may link to the same ModulationDatabase, register it with
+        // Processor::registerModulation so its routing is switched once per block.
         void link(ModulationDatabase& database) { m_LinkedModulationDatabase = &database; }
 #endif
         // ------------------------------------------------
 
-        ParamValue read(ParamID id) { return m_Parameters[id].access; }
+        ParamValue read(ParamID id) const { return m_Access[id]; }
+
+        // Start a ramp from the current value to the goal at the current sample.
+        void ramp(ParamID id, ParamValue goal) { 
+            m_Goal[id] = goal;
+            update();
+            m_Changing.set(id); 
+            startRamp(id);
+        }
+
+        // Immediately set the value, stops any ramp.
+        void snap(ParamID id, ParamValue value) {
+            if (m_Lane[id] != NoLane) removeLane(m_Lane[id]);
+            m_Value[id] = m_Goal[id] = m_Access[id] = value;
+        }
 
-        void setChanging(ParamID id) { m_Changing.set(id); }
+        /**
+         * Schedule a parameter change a number of samples from now, the ramp to
+         * the new value then starts at exactly that sample. When too many events
+         * are scheduled, the event is applied immediately.
+         * @param id parameter
+         * @param value new normalized value
+         * @param offset samples from now
+         */
+        void schedule(ParamID id, ParamValue value, std::size_t offset) {
+            if (offset == 0 || m_Events.size() == m_Events.capacity()) return param(id, value);
+
+            const Event event{ .id = id, .value = value, .time = m_Time + offset };
+            auto at = m_Events.begin();
+            while (at != m_Events.end() && at->time <= event.time) ++at;
+            m_Events.insert(at, event);
+        }
 
         // ------------------------------------------------
 
         void process() override {
-            m_SamplesSinceInterpolation++;
-            if (m_SamplesSinceInterpolation >= m_InterpolateEvery) {
-                m_SamplesSinceInterpolation = 0;
-                
-                float r = 1.f / m_InterpolateEvery;
-
-                m_Changing.foreach([&](ParamID i) {
-                    m_Parameters[i].add = r * (m_Parameters[i].goal - m_Parameters[i].value);
-
-                    if (!changing(i)) {
-                        Kaixo::Processing::assignParameter<Name, Names...>(*this, i, m_Parameters[i].goal);
-                        m_Changing.unset(i);
-                    }
-                });
-            }
+            if (!m_Events.empty() && m_Events.front().time <= m_Time) applyEvents();
+            if (m_UntilUpdate == 0) update();
+#ifdef KAIXO_INTERNAL_MODULATION
+            if (matrix().version != m_MatrixVersion) relink();
+#endif
+
+            --m_UntilUpdate;
+            ++m_Time;
+            advance(1);
 
 #ifdef KAIXO_INTERNAL_MODULATION
             Kaixo::Processing::assignSources<Name, Names...>(*this);
+            if (m_InterpolateSources) {
+                for (std::size_t i = 0; i < 2 * Sources; ++i) m_Inputs[i] += m_InputStep[i];
+            }
+
+            modulate();
+            m_Processed = m_Time;
 #endif
             Kaixo::Processing::assignParameters<Name, Names...>(*this);
         }
 
+        /**
+         * Advance the smoothing by multiple samples at once. The skipped samples
+         * advance the ramps, and the interpolation of control rate sources and
+         * modulation, process() runs at the end of ramp segments, at scheduled 
+         * events, and on the last sample of the block. Sources are only assigned
+         * and modulation only computed at those samples, so a control rate that
+         * is due in between is evaluated late, and its interpolation stops at
+         * its target until then. Call process() per sample when modulation has
+         * to be sample accurate.
+         */
+        void processBlock(std::size_t samples) override {
+            while (samples > 0) {
+                std::size_t skip = Math::min(m_UntilUpdate, samples - 1);
+                if (!m_Events.empty()) skip = Math::min(skip, m_Events.front().time - Math::min(m_Events.front().time, m_Time));
+
+                if (skip > 0) {
+                    advance(skip);
+#ifdef KAIXO_INTERNAL_MODULATION
+                    interpolate(skip);
+#endif
+                    m_UntilUpdate -= skip;
+                    m_Time += skip;
+                }
+
+                process();
+                samples -= skip + 1;
+            }
+        }
+
         void prepare(double sampleRate, std::size_t maxBufferSize) override {
             Module::prepare(sampleRate, maxBufferSize);
-            m_InterpolateEvery = (m_MillisToInterpolate / 1000.f) * sampleRate;
+            m_RampSamples = Math::max(static_cast<std::size_t>((m_MillisToInterpolate / 1000.f) * sampleRate), 1ull);
             reset();
         }
 
         void reset() override { 
+            m_Events.clear();
             rebase(); 
 #ifdef KAIXO_INTERNAL_MODULATION
-            for (Source& source : m_Sources)
-                source.value = source.normalized = 0;
+            m_Inputs.fill(0);
+            m_InputStep.fill(0);
+            m_InputTarget.fill(0);
+            m_ModulationOffset.fill(0);
+            m_ModulationStep.fill(0);
+            m_ModulationTarget.fill(0);
+            m_Processed = npos; // Evaluate everything on the next sample
 #endif
         }
 
         void rebase() {
-            m_SamplesSinceInterpolation = 0;
+            m_Ramps.size = 0;
             for (ParamID id = 0; id < Parameters; ++id) {
-                m_Parameters[id].value = m_Parameters[id].access = m_Parameters[id].goal;
-                m_Parameters[id].add = 0;
+                m_Value[id] = m_Access[id] = m_Goal[id];
+                m_Lane[id] = NoLane;
+            }
 
 #ifdef KAIXO_INTERNAL_MODULATION
-                if (m_LinkedModulationDatabase->modulated(id)) {
-                    m_Changing.set(id);
-                }
+            relink();
 #endif
-            }
+
+            m_UntilUpdate = m_SegmentLength = m_RampSamples;
         }
 
         // ------------------------------------------------
@@ -113,26 +193,55 @@ namespace Kaixo::Processing {
         
         constexpr bool necessary(ParamID id) const { return m_Changing.test(id); }
 
+        // Calls the function with the id of every parameter that is ramping or modulated.
+        constexpr void foreachChanging(auto fun) { m_Changing.foreach(fun); }
+
         constexpr Self& self() { return *m_Self; }
-        constexpr Param& parameter(ParamID id) { return m_Parameters[id]; }
+        constexpr ParamValue value(ParamID id) const { return m_Value[id]; }
+        constexpr ParamValue& access(ParamID id) { return m_Access[id]; }
 
 #ifdef KAIXO_INTERNAL_MODULATION
-        constexpr Source& source(ModulationSourceID id) { return m_Sources[id]; }
-        constexpr const Source& source(ModulationSourceID id) const { return m_Sources[id]; }
+        constexpr Source source(ModulationSourceID id) const { return { m_Inputs[id], m_Inputs[Sources + id] }; }
+        constexpr void source(ModulationSourceID id, float value) { source(id, value, value); }
+        constexpr void source(ModulationSourceID id, float value, float normalized) {
+            if (m_SourceRate[id] == 1) {
+                m_Inputs[id] = value;
+                m_Inputs[Sources + id] = normalized;
+            } else { // Interpolate to the new value until the source is evaluated again
+                const float rate = static_cast<float>(m_SourceRate[id]);
+                m_InputTarget[id] = value;
+                m_InputTarget[Sources + id] = normalized;
+                m_InputStep[id] = (value - m_Inputs[id]) / rate;
+                m_InputStep[Sources + id] = (normalized - m_Inputs[Sources + id]) / rate;
+            }
+        }
+
+        // Whether something running at the control rate should be evaluated this sample.
+        constexpr bool due(std::size_t rate) const { return m_Time / rate != m_Processed / rate; }
+
+        const ModulationMatrix& matrix() const { return m_LinkedModulationDatabase->matrix(); }
 
         constexpr void loopOverSources(ParamID id, auto fun) const {
-            m_LinkedModulationDatabase->foreach(id, fun);
+            const ModulationMatrix& m = matrix();
+            if (!m.modulated(id)) return;
+            const std::uint32_t row = m.row[id];
+            for (std::uint32_t i = m.offsets[row]; i < m.offsets[row + 1]; ++i) {
+                fun(m.sources[i], m.amounts[i]);
+            }
         }
 
         constexpr float modulationAmount(ParamID id, ModulationSourceID source) const {
-            return m_LinkedModulationDatabase->get(id, source);
+            float result = 0;
+            loopOverSources(id, [&](ModulationSourceID s, float amount) { if (s == source) result = amount; });
+            return result;
         }
 #endif
 
         // ------------------------------------------------
 
     protected:
-        constexpr static std::size_t m_MillisToInterpolate = 2;
+        constexpr static std::size_t m_MillisToInterpolate = 2; // Default ramp time
+        constexpr static std::size_t m_ExponentialSegment = 16; // Exponential ramps are linear over segments of this many samples
 
         // ------------------------------------------------
 
@@ -141,25 +250,301 @@ namespace Kaixo::Processing {
         // ------------------------------------------------
 
 #ifdef KAIXO_INTERNAL_MODULATION
+        constexpr static std::size_t m_TermChunk = 64; // Modulation terms are computed in chunks of this size
+
         ModulationDatabase* m_LinkedModulationDatabase = nullptr;
-        std::array<Source, Sources> m_Sources{};
+        std::uint64_t m_MatrixVersion = 0;
+        std::size_t m_Processed = npos; // Value of m_Time at the last processed sample
+        alignas(64) std::array<float, 2 * Sources> m_Inputs{}; // Value of all sources, followed by their normalized values
+        alignas(64) std::array<float, 2 * Sources> m_InputStep{};
+        alignas(64) std::array<float, 2 * Sources> m_InputTarget{}; // Where the interpolation stops
+        alignas(64) std::array<float, m_TermChunk> m_Terms{};
+        std::array<std::size_t, Sources> m_SourceRate{};
+        bool m_InterpolateSources = false;
+
+        // Parameters with a control rate interpolate the modulation on top of the smoothed value
+        std::array<ParamValue, Parameters> m_ModulationOffset{};
+        std::array<ParamValue, Parameters> m_ModulationStep{};
+        std::array<ParamValue, Parameters> m_ModulationTarget{};
 #endif
-        std::array<Param, Parameters> m_Parameters;
-        StateVector<ParamID, Parameters> m_Changing;
+        std::array<ParamValue, Parameters> m_Value{};  // Smoothed value
+        std::array<ParamValue, Parameters> m_Goal{};   // Value the ramp is heading to
+        std::array<ParamValue, Parameters> m_Access{}; // Smoothed and modulated value
+        std::array<std::size_t, Parameters> m_Lane{};  // Index in m_Ramps, or NoLane when not ramping
+        StateVector<ParamID, Parameters> m_Changing;   // Parameters that are ramping or modulated
+        Ramps m_Ramps{};
+
+        // ------------------------------------------------
+
+        struct Event {
+            ParamID id;
+            ParamValue value;
+            std::size_t time;
+        };
+
+        Vector<Event, 64> m_Events{}; // Scheduled events, sorted by time
+        std::size_t m_Time = 0;       // Samples processed since prepare
+
+        // ------------------------------------------------
+
+        std::size_t m_RampSamples = 96;   // Default ramp length
+        std::size_t m_UntilUpdate = 96;   // Samples until the first ramp segment ends
+        std::size_t m_SegmentLength = 96; // Value of m_UntilUpdate at the last update
 
         // ------------------------------------------------
 
-        std::size_t m_SamplesSinceInterpolation = 0;
-        std::size_t m_InterpolateEvery = 100;
+        void applyEvents() {
+            while (!m_Events.empty() && m_Events.front().time <= m_Time) {
+                const Event event = m_Events.front();
+                m_Events.pop_front();
+                param(event.id, event.value);
+            }
+        }
+
+        // ------------------------------------------------
+
+        // Advance all ramps by a number of samples, and write the values back.
+        void advance(std::size_t samples) {
+            const std::size_t size = m_Ramps.size;
+            const ParamValue amount = static_cast<ParamValue>(samples);
+            for (std::size_t i = 0; i < size; ++i) {
+                m_Ramps.value[i] += amount * m_Ramps.add[i];
+            }
+
+            for (std::size_t i = 0; i < size; ++i) {
+                m_Value[m_Ramps.id[i]] = m_Access[m_Ramps.id[i]] = m_Ramps.value[i];
+            }
+        }
+
+        // ------------------------------------------------
+
+        std::size_t rampSamples(ParamID id) const {
+            const float millis = Kaixo::parameter(id).smoothTime;
+            if (millis <= 0) return m_RampSamples;
+            return Math::max(static_cast<std::size_t>((millis / 1000.f) * sampleRate()), 1ull);
+        }
+
+        void startRamp(ParamID id) {
+            std::size_t lane = m_Lane[id];
+            if (lane == NoLane) {
+                lane = m_Lane[id] = m_Ramps.size++;
+                m_Ramps.id[lane] = id;
+                m_Ramps.value[lane] = m_Value[id];
+                m_Ramps.add[lane] = 0;
+            }
+
+            nextSegment(lane);
+            if (m_Ramps.remaining[lane] == 0) return removeLane(lane);
+            m_UntilUpdate = m_SegmentLength = Math::min(m_UntilUpdate, m_Ramps.remaining[lane]);
+        }
+
+        // Keep a parameter that is not ramping changing until the next update, so its
+        // current value is assigned at least once more.
+        void hold(ParamID id) {
+            const std::size_t lane = m_Lane[id] = m_Ramps.size++;
+            m_Ramps.id[lane] = id;
+            m_Ramps.value[lane] = m_Ramps.target[lane] = m_Access[id] = m_Value[id];
+            m_Ramps.add[lane] = 0;
+            m_Ramps.remaining[lane] = 1;
+        }
+
+        // Moves the last lane into the removed one, to keep them packed.
+        void removeLane(std::size_t lane) {
+            m_Lane[m_Ramps.id[lane]] = NoLane;
+            const std::size_t last = --m_Ramps.size;
+            if (lane == last) return;
+
+            m_Ramps.value[lane] = m_Ramps.value[last];
+            m_Ramps.add[lane] = m_Ramps.add[last];
+            m_Ramps.target[lane] = m_Ramps.target[last];
+            m_Ramps.remaining[lane] = m_Ramps.remaining[last];
+            m_Ramps.id[lane] = m_Ramps.id[last];
+            m_Lane[m_Ramps.id[lane]] = lane;
+        }
+
+        // Start the next segment of the ramp from the current value to the goal. A linear 
+        // ramp is a single segment, an exponential ramp is approximated with short linear
+        // segments. Once at the goal, it is held for one sample so it is assigned exactly.
+        void nextSegment(std::size_t lane) {
+            const ParamID id = m_Ramps.id[lane];
+            auto& add = m_Ramps.add[lane];
+            auto& target = m_Ramps.target[lane];
+            auto& remaining = m_Ramps.remaining[lane];
+            const ParamValue value = m_Ramps.value[lane];
+            const ParamValue distance = m_Goal[id] - value;
+
+            if (distance == 0) {
+                remaining = add != 0 ? 1 : 0;
+                target = m_Goal[id];
+                add = 0;
+                return;
+            }
+
+            const std::size_t length = rampSamples(id);
+            if (Kaixo::parameter(id).smoothing == Smoothing::Exponential) {
+                // Reaches ~99% of the distance after the ramp length
+                const std::size_t segment = Math::min(m_ExponentialSegment, length);
+                const ParamValue remain = distance * Math::exp(-5.f * segment / length);
+                target = Math::Fast::abs(remain) < 0.0001f ? m_Goal[id] : m_Goal[id] - remain;
+                remaining = segment;
+            } else {
+                target = m_Goal[id];
+                remaining = length;
+            }
+
+            add = (target - value) / remaining;
+        }
+
+        // Apply the samples elapsed since the last update to all ramps, start the next
+        // segment of the ramps that ended, and find when the next segment ends. Runs at
+        // least once every default ramp length to stop tracking finished parameters.
+        void update() {
+            const std::size_t elapsed = m_SegmentLength - m_UntilUpdate;
+            std::size_t next = m_RampSamples;
+
+            for (std::size_t lane = 0; lane < m_Ramps.size;) {
+                auto& remaining = m_Ramps.remaining[lane];
+                remaining -= Math::min(elapsed, remaining);
+                if (remaining == 0) {
+                    // Remove accumulated rounding errors
+                    m_Value[m_Ramps.id[lane]] = m_Ramps.value[lane] = m_Ramps.target[lane];
+                    nextSegment(lane);
+                    if (remaining == 0) {
+                        removeLane(lane); // Last lane moved here, so check this lane again
+                        continue;
+                    }
+                }
+
+                next = Math::min(next, remaining);
+                ++lane;
+            }
+
+#ifdef KAIXO_INTERNAL_MODULATION
+            if (matrix().version != m_MatrixVersion) relink();
+#endif
+
+            // Stop tracking parameters that are done, and not modulated
+            m_Changing.unset_if([&](ParamID i) { return !changing(i); });
+
+            m_UntilUpdate = m_SegmentLength = next;
+        }
+
+        // ------------------------------------------------
+
+#ifdef KAIXO_INTERNAL_MODULATION
+        // Compute the modulated value of all modulated parameters, groups with a
+        // control rate are only computed when due, and interpolated in between.
+        void modulate() {
+            const ModulationMatrix& m = matrix();
+            for (const ModulationMatrix::Group& group : m.groups) {
+                if (group.rate == 1) {
+                    modulate(group.first, group.last, [&](std::uint32_t row, ParamValue value) {
+                        m_Access[m.params[row]] = constrain(m, row, value);
+                    });
+                    continue;
+                }
+
+                if (due(group.rate)) {
+                    modulate(group.first, group.last, [&](std::uint32_t row, ParamValue value) {
+                        const ParamID id = m.params[row];
+                        m_ModulationTarget[id] = value - m_Value[id];
+                        m_ModulationStep[id] = (m_ModulationTarget[id] - m_ModulationOffset[id]) / group.rate;
+                    });
+                }
+
+                for (std::uint32_t row = group.first; row < group.last; ++row) {
+                    const ParamID id = m.params[row];
+                    m_ModulationOffset[id] += m_ModulationStep[id];
+                    m_Access[id] = constrain(m, row, m_Value[id] + m_ModulationOffset[id]);
+                }
+            }
+        }
+
+        // Interpolate the sources and control rate modulation over samples that are skipped 
+        // by processBlock. Without process() nothing is re-evaluated when it is due, so 
+        // the values stop at their target, where they would be when calling process().
+        void interpolate(std::size_t samples) {
+            const float amount = static_cast<float>(samples);
+            auto approach = [amount](float value, float step, float target) {
+                const float next = value + amount * step;
+                if (step > 0) return Math::min(next, target);
+                if (step < 0) return Math::max(next, target);
+                return value;
+            };
+
+            if (m_InterpolateSources) {
+                for (std::size_t i = 0; i < 2 * Sources; ++i) {
+                    m_Inputs[i] = approach(m_Inputs[i], m_InputStep[i], m_InputTarget[i]);
+                }
+            }
+
+            const ModulationMatrix& m = matrix();
+            for (const ModulationMatrix::Group& group : m.groups) {
+                if (group.rate == 1) continue;
+                for (std::uint32_t row = group.first; row < group.last; ++row) {
+                    const ParamID id = m.params[row];
+                    m_ModulationOffset[id] = approach(m_ModulationOffset[id], m_ModulationStep[id], m_ModulationTarget[id]);
+                }
+            }
+        }
+
+        /**
+         * Compute the modulated value of a range of rows. First all terms 
+         * (amount * source + bias) of a chunk of entries are computed in a single 
+         * gather and multiply-add loop, after which they are folded into the rows.
+         */
+        void modulate(std::uint32_t first, std::uint32_t last, auto write) {
+            const ModulationMatrix& m = matrix();
+            const std::size_t entries = m.offsets[last];
+
+            std::uint32_t row = first;
+            ParamValue value = m_Value[m.params[row]];
+            for (std::size_t begin = m.offsets[first]; begin < entries; begin += m_TermChunk) {
+                const std::size_t end = Math::min(begin + m_TermChunk, entries);
+                for (std::size_t i = begin; i < end; ++i) {
+                    m_Terms[i - begin] = m.amounts[i] * m_Inputs[m.inputs[i]] + m.bias[i];
+                }
+
+                std::size_t i = begin;
+                while (i < end) {
+                    const std::size_t rowEnd = m.offsets[row + 1];
+                    const std::size_t stop = Math::min(rowEnd, end);
+                    if (m.flags[row] & ModulationMatrix::Multiply) for (; i < stop; ++i) value *= m_Terms[i - begin];
+                    else for (; i < stop; ++i) value += m_Terms[i - begin];
+
+                    if (i == rowEnd) {
+                        write(row, value);
+                        if (++row < last) value = m_Value[m.params[row]];
+                    }
+                }
+            }
+        }
+
+        ParamValue constrain(const ModulationMatrix& m, std::uint32_t row, ParamValue value) const {
+            return (m.flags[row] & ModulationMatrix::Constrain) ? Math::Fast::clamp1(value) : value;
+        }
+
+        // The routing changed, parameters that are no longer modulated go back to their
+        // smoothed value, and the newly modulated parameters start being tracked.
+        void relink() {
+            const ModulationMatrix& m = matrix();
+            m_MatrixVersion = m.version;
+            m_Processed = npos; // Recompute all control rate groups
+            m_Changing.foreach([&](ParamID id) {
+                if (!m.modulated(id) && m_Lane[id] == NoLane) hold(id);
+            });
+
+            for (ParamID id : m.params) m_Changing.set(id);
+        }
+#endif
 
         // ------------------------------------------------
 
         constexpr bool changing(ParamID i) const {
 #ifdef KAIXO_INTERNAL_MODULATION
-            return m_LinkedModulationDatabase->modulated(i)
-                || Math::Fast::abs(m_Parameters[i].add) > 0.00000005f;
+            return matrix().modulated(i) || m_Lane[i] != NoLane;
 #else
-            return Math::Fast::abs(m_Parameters[i].add) > 0.00000005f;
+            return m_Lane[i] != NoLane;
 #endif
         }
 
@@ -5,6 +5,7 @@
 #include "Kaixo/Core/Processing/Buffer.hpp"
 #include "Kaixo/Core/Processing/Module.hpp"
 #include "Kaixo/Core/Processing/Interface.hpp"
+#include "Kaixo/Core/Processing/Profiler.hpp"
 
 // ------------------------------------------------
 
@@ -16,12 +17,20 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
+    class ModulationDatabase;
+
+    // ------------------------------------------------
+
     class Processor : public ModuleContainer, public Serializable {
     public:
 
         // ------------------------------------------------
 
-        Processor() = default;
+        Processor() {
+#ifdef KAIXO_PROFILE_MODULES
+            registerInterface<ProfilerInterface>();
+#endif
+        }
         virtual ~Processor() = default;
 
         // ------------------------------------------------
@@ -39,6 +48,9 @@ namespace Kaixo::Processing {
         
         virtual bool isActive() const { return true; }
 
+        // The processor renders the whole output buffer in process().
+        void processBlock(std::size_t) override { process(); }
+
         // ------------------------------------------------
 
         virtual void init() override {}
@@ -56,9 +68,16 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+        // Not realtime safe, register every ModulationDatabase that a ParameterDatabase links
+        // to. The controller switches them to their latest routing once per block, before process().
+        void registerModulation(ModulationDatabase& database) { m_ModulationDatabases.push_back(&database); }
+
+        // ------------------------------------------------
+
     private:
         std::vector<ParamValue> m_ParameterValues{};
         std::map<std::type_index, std::unique_ptr<Interface>> m_Interfaces{};
+        std::vector<ModulationDatabase*> m_ModulationDatabases{};
 
         // ------------------------------------------------
 
@@ -69,6 +88,9 @@ namespace Kaixo::Processing {
 
         void receiveParameterValue(ParamID id, ParamValue value);
 
+        // Audio thread only, the single reader of the published routing.
+        void updateModulation();
+
         // ------------------------------------------------
 
         friend class ::Kaixo::Controller;
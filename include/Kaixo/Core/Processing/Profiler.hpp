@@ -0,0 +1,161 @@
+#pragma once
+#include "Kaixo/Core/Definitions.hpp"
+#include "Kaixo/Core/Processing/Interface.hpp"
+
+// ------------------------------------------------
+
+// Time a module from here to the end of the scope, use at the start of
+// process() of modules that are not already timed by their owner.
+#ifdef KAIXO_PROFILE_MODULES
+#define KAIXO_PROFILE_MODULE() const auto _kaixoProfileScope = this->profile()
+#else
+#define KAIXO_PROFILE_MODULE()
+#endif
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+#ifdef KAIXO_PROFILE_MODULES
+
+    /**
+     * Per-module CPU usage. Every module registered in a ModuleContainer gets
+     * a node, with its container as parent. Time is added to a node from any
+     * thread while processing, and at the end of every block the audio thread
+     * turns it into statistics. Every 250 ms of audio the statistics are
+     * published, read them through the ProfilerInterface.
+     *
+     * The processor and the voices/batches of a VoiceBank are timed by the
+     * framework, other modules are timed with KAIXO_PROFILE_MODULE(). Time is
+     * inclusive, so a node also contains the time of its timed children.
+     */
+    class Profiler {
+    public:
+
+        // ------------------------------------------------
+
+        using clock = std::chrono::steady_clock;
+
+        constexpr static std::uint32_t NoNode = static_cast<std::uint32_t>(-1);
+        constexpr static std::size_t History = 256; // Blocks used for the min, max and p99
+
+        // ------------------------------------------------
+
+        struct Entry {
+            std::uint32_t parent = NoNode;
+            float nanosPerSample = 0;     // Average over all samples, including blocks it didn't run
+            float selfNanosPerSample = 0; // Same, without the time of its children, at least 0
+            float percentCPU = 0;         // Of the time available per sample
+            float minNanosPerSample = 0;  // Per block, only for blocks it ran in
+            float maxNanosPerSample = 0;
+            float p99NanosPerSample = 0;
+        };
+
+        // ------------------------------------------------
+
+        class Scope {
+        public:
+            Scope(Profiler* profiler, std::uint32_t node)
+                : m_Profiler(profiler), m_Node(node), m_Start(clock::now())
+            {}
+
+            ~Scope() { if (m_Profiler) m_Profiler->add(m_Node, clock::now() - m_Start); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Profiler* m_Profiler;
+            std::uint32_t m_Node;
+            clock::time_point m_Start;
+        };
+
+        // ------------------------------------------------
+
+        // Not realtime safe, nodes are added while constructing the processor.
+        std::uint32_t create(std::string_view type, std::uint32_t parent);
+
+        std::size_t nodes() const { return m_Nodes.size(); }
+        std::string_view name(std::uint32_t node) const { return m_Nodes[node].name; }
+
+        // ------------------------------------------------
+
+        // Not realtime safe, sizes the published statistics, call once all nodes are created.
+        void allocate();
+
+        // Call while not processing, starts a new measurement.
+        void prepare(double sampleRate);
+
+        // ------------------------------------------------
+
+        // Any thread, add time to a node for the current block.
+        void add(std::uint32_t node, clock::duration time) {
+            if (node == NoNode) return;
+            m_Nodes[node].nanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), std::memory_order_relaxed);
+            m_Nodes[node].calls.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Audio thread only, call after every block.
+        void endBlock(std::size_t samples);
+
+        // Audio thread only, publish the statistics of the current window.
+        void publish();
+
+        // ------------------------------------------------
+
+        // Reader only, latest published statistics, same order as the nodes.
+        std::span<const Entry> entries() {
+            m_Entries.update();
+            return m_Entries.front();
+        }
+
+        // ------------------------------------------------
+
+    private:
+        struct Node {
+            std::string name;
+            std::string type;
+            std::uint32_t parent = NoNode;
+
+            std::atomic<std::uint64_t> nanos = 0; // Current block
+            std::atomic<std::uint32_t> calls = 0;
+
+            std::uint64_t windowNanos = 0;
+            std::array<float, History> history{}; // Nanos per sample of the blocks it ran in this window
+            std::size_t written = 0;
+        };
+
+        // ------------------------------------------------
+
+        std::deque<Node> m_Nodes{};
+        TripleBuffer<std::vector<Entry>> m_Entries{};
+        std::array<float, History> m_Sorted{};
+        std::uint64_t m_WindowSamples = 0;
+        double m_SampleRate = 48000;
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    class ProfilerInterface : public Interface {
+    public:
+
+        // ------------------------------------------------
+
+        // One entry per module, parents come before their children.
+        std::span<const Profiler::Entry> entries();
+        std::string_view name(std::uint32_t node);
+
+        // ------------------------------------------------
+
+    };
+
+#endif
+
+    // ------------------------------------------------
+
+}
@@ -3,8 +3,7 @@
 // ------------------------------------------------
 
 #include "Kaixo/Core/Definitions.hpp"
-#include "Kaixo/Core/Processing/Filter.hpp"
-#include "Kaixo/Core/Processing/Buffer.hpp"
+#include "Kaixo/Core/Processing/Stereo.hpp"
 
 // ------------------------------------------------
 
@@ -12,65 +11,97 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
-    struct Resampler {
+    /**
+     * Streaming sample rate converter for arbitrary, fractional and changing
+     * ratios. Every output sample is a dot product of a Kaiser windowed sinc
+     * with the input history, the kernel comes from a precomputed polyphase
+     * table and is linearly interpolated between the two nearest phases.
+     * When downsampling the cutoff has to drop with the ratio, so there is a
+     * table per quarter octave of cutoff, down to a ratio of 4. Above that
+     * the signal aliases. The tables are shared by all resamplers and built
+     * by the first constructor. The transition band is about 0.08 of the
+     * input rate on both sides of the cutoff, so at 48 kHz without
+     * downsampling the passband is flat up to 21 kHz.
+     */
+    class Resampler {
+    public:
 
         // ------------------------------------------------
 
+        constexpr static std::size_t Taps = 32;    // Kernel length at the full band cutoff
+        constexpr static std::size_t Phases = 128; // Table rows per input sample
+        constexpr static std::size_t Levels = 9;   // Cutoffs, in quarter octave steps
+        constexpr static std::size_t MaxTaps = Taps << ((Levels - 1) / 4);
+
+        // ------------------------------------------------
+
+        struct Result {
+            std::size_t consumed = 0; // Input samples
+            std::size_t produced = 0; // Output samples
+        };
+
+        // ------------------------------------------------
+
+        // Changing these is realtime safe, and takes effect on the next output sample.
         struct {
-            double in;
-            double out;
+            double in = 48000;
+            double out = 48000;
         } samplerate;
 
         // ------------------------------------------------
 
-        Stereo generate(auto generator) {
-            Stereo input = { 0, 0 };
+        Resampler();
 
-            // ------------------------------------------------
+        // ------------------------------------------------
 
-            const double delta = (samplerate.in / samplerate.out);
+        void reset();
 
-            // ------------------------------------------------
+        // Delay of the output, in input samples.
+        constexpr static double latency() { return MaxTaps / 2.; }
 
-            if (delta < 1) { // Upsample
-                filter.sampleRateIn = samplerate.in;
-                filter.sampleRateOut = samplerate.out;
+        // ------------------------------------------------
 
-                const std::int64_t count = static_cast<std::int64_t>(leftovers + delta);
+        /**
+         * Consumes input until the output is full, or the input runs out.
+         * Leftover input was not consumed, pass it again in the next call.
+         */
+        Result process(std::span<const Stereo> in, std::span<Stereo> out);
 
-                if (count) {
-                    input += filter.process(generator());
-                } else {
-                    input += filter.process({ 0, 0 });
-                }
+        // Single output sample, calls the generator for every input sample it needs.
+        Stereo generate(auto generator) {
+            for (; m_Pending > 0; --m_Pending) push(generator());
+            return next();
+        }
 
-                input /= delta;
+        // ------------------------------------------------
 
-                leftovers = (leftovers + delta) - count;
+    private:
+        struct Table;
 
-            } else { // Downsample
-                filter.sampleRateIn = samplerate.in;
-                filter.sampleRateOut = samplerate.out;
+        // ------------------------------------------------
 
-                const std::int64_t count = static_cast<std::int64_t>(leftovers + delta);
-                for (std::int64_t i = 0; i < count; ++i) {
-                    input += filter.process(generator());
-                }
+        alignas(16) float m_Left[2 * MaxTaps]{}; // History is stored twice, so the window is contiguous
+        alignas(16) float m_Right[2 * MaxTaps]{};
+        std::size_t m_Write = 0;
 
-                input /= count;
+        double m_Fraction = 0;     // Position of the next output between 2 input samples
+        std::size_t m_Pending = 1; // Input samples to push before the next output
 
-                leftovers = (leftovers + delta) - count;
-            }
+        double m_Ratio = 0;
+        const Table* m_Table = nullptr; // Coefficients for the cutoff of m_Ratio
 
-            // ------------------------------------------------
+        // ------------------------------------------------
 
-            return input;
-        }
+        void push(Stereo sample);
+        Stereo next();
+
+        // Shared by all resamplers, built on the first call.
+        static const Table& table(std::size_t level);
 
         // ------------------------------------------------
 
-    private:
-        double leftovers = 0;
-        AAFilter filter;
     };
-}
\ No newline at end of file
+
+    // ------------------------------------------------
+
+}
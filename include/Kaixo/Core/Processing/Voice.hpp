@@ -19,7 +19,7 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
-        NoteID id; // unique note identifier, only used in MPE mode
+        NoteID id = NoNoteID; // unique note identifier, only used in MPE mode
         Note fromNote = -1; // Previous note (to allow gliding)
         Note note = -1; // Pressed note
         int channel = 0;
@@ -40,6 +40,17 @@ namespace Kaixo::Processing {
 
         virtual Note currentNote() const { return note; }
 
+        // Voices render their whole output buffer in process().
+        void processBlock(std::size_t) override { process(); }
+
+        // Current loudness, used when stealing the quietest voice. Defaults to
+        // the last output sample, override to return e.g. the envelope level.
+        virtual float level() const {
+            if (output.size() == 0) return 0;
+            const Stereo& last = output[output.size() - 1];
+            return Math::max(Math::abs(last.l), Math::abs(last.r));
+        }
+
         // ------------------------------------------------
 
         virtual void notePitchBendMPE(double value) {}
@@ -48,8 +59,135 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
+        // Per-note expression value that ramps linearly to its goal, so it can 
+        // be read every sample without stepping. The VoiceBank sets the goal 
+        // at the sample the MPE message arrives.
+        struct Expression {
+
+            // ------------------------------------------------
+
+            float value = 0;
+
+            // ------------------------------------------------
+
+            void set(float goal, std::size_t samples) {
+                m_Goal = goal;
+                m_Remaining = samples;
+                if (samples == 0) value = goal, m_Delta = 0;
+                else m_Delta = (goal - value) / samples;
+            }
+
+            // Immediately jump to the value, used when the note starts.
+            void reset(float goal) { set(goal, 0); }
+
+            // ------------------------------------------------
+
+            float next() {
+                if (m_Remaining == 0) return value;
+                if (--m_Remaining == 0) return value = m_Goal;
+                return value += m_Delta;
+            }
+
+            // ------------------------------------------------
+
+        private:
+            float m_Goal = 0;
+            float m_Delta = 0;
+            std::size_t m_Remaining = 0;
+
+            // ------------------------------------------------
+
+        };
+
+        Expression pitchBend{};
+        Expression pressure{};
+        Expression timbre{};
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Voices can opt in to being processed in batches by the VoiceBank, 
+     * so per-sample work can be done for several voices at once using simd 
+     * types. The voice derives from BatchedVoice with a Batch type that has
+     * a static Lanes count and a process method:
+     * 
+     *   class MyVoice : public BatchedVoice<MyBatch> { ... };
+     * 
+     *   struct MyBatch : ModuleContainer {
+     *       constexpr static std::size_t Lanes = 4;
+     *       BatchEnvelope<Lanes> envelope;
+     *       void process(std::array<MyVoice*, Lanes>& voices);
+     *   };
+     * 
+     * The VoiceBank keeps one Batch for every Lanes consecutive voices and
+     * calls its process instead of the process of the voices themselves. 
+     * Voices that don't fit in a full batch are processed normally. A voice
+     * finds its state in the batch through its batch pointer and lane, which
+     * is null while the voice is processed normally. When a voice keeps its
+     * envelope in the batch, give the batch an active(lane) method, so the
+     * voice stays active until its lane is done.
+     * 
+     * Batched modules: BatchEnvelope, and Biquad, BiquadCascade and
+     * BatchEqualizer with Parallel set to Lanes. There is no batched Lfo or
+     * parameter smoothing, keep those per voice and read them per lane.
+     */
+    template<class BatchType>
+    class BatchedVoice : public Voice {
+    public:
+
+        // ------------------------------------------------
+
+        using Batch = BatchType;
+
+        // ------------------------------------------------
+
+        Batch* batch = nullptr;
+        std::size_t lane = 0;
+
+        // ------------------------------------------------
+
+        bool active() const override {
+            if constexpr (requires (const Batch& batch, std::size_t lane) { { batch.active(lane) } -> std::convertible_to<bool>; }) {
+                if (batch && batch->active(lane)) return true;
+            }
+
+            return Voice::active();
+        }
+
+        // ------------------------------------------------
+
     };
 
     // ------------------------------------------------
 
+    template<class VoiceClass>
+    concept batched_voice = requires (typename VoiceClass::Batch& batch, std::array<VoiceClass*, VoiceClass::Batch::Lanes>& voices) {
+        batch.process(voices);
+    } && std::derived_from<VoiceClass, BatchedVoice<typename VoiceClass::Batch>>;
+
+    // ------------------------------------------------
+
+    struct NoBatch {};
+
+    template<class VoiceClass> 
+    struct batch_traits {
+        using type = NoBatch;
+        constexpr static std::size_t lanes = 1;
+    };
+
+    template<batched_voice VoiceClass> 
+    struct batch_traits<VoiceClass> {
+        using type = typename VoiceClass::Batch;
+        constexpr static std::size_t lanes = VoiceClass::Batch::Lanes;
+    };
+
+    template<class VoiceClass> using batch_type = typename batch_traits<VoiceClass>::type;
+    template<class VoiceClass> constexpr std::size_t batch_lanes = batch_traits<VoiceClass>::lanes;
+
+    // ------------------------------------------------
+
 }
\ No newline at end of file
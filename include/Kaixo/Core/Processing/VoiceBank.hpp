@@ -4,6 +4,7 @@
 #include "Kaixo/Core/Processing/Processor.hpp"
 #include "Kaixo/Core/Processing/Voice.hpp"
 #include "Kaixo/Core/Processing/Module.hpp"
+#include "Kaixo/Core/Processing/WorkerPool.hpp"
 
 // ------------------------------------------------
 
@@ -11,22 +12,102 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
+    /**
+     * Open addressing hash map from NoteID to voice, with linear probing. Has
+     * twice as many slots as voices, so it never fills up, and never allocates.
+     */
+    template<std::size_t Count>
+    struct NoteIDMap {
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t Slots = std::bit_ceil(2 * Count);
+        constexpr static std::size_t NoVoice = static_cast<std::size_t>(-1);
+
+        // ------------------------------------------------
+
+        struct Slot {
+            NoteID id = NoNoteID;
+            std::size_t voice = NoVoice;
+        };
+
+        std::array<Slot, Slots> slots{};
+
+        // ------------------------------------------------
+
+        // Slot where the probe sequence of the id starts.
+        static std::size_t home(NoteID id) { return ((id * 0x9E3779B97F4A7C15ull) >> 32) % Slots; }
+
+        // ------------------------------------------------
+
+        std::size_t find(NoteID id) const {
+            if (id == NoNoteID) return NoVoice;
+            for (std::size_t i = home(id);; i = (i + 1) % Slots) {
+                if (slots[i].id == id) return slots[i].voice;
+                if (slots[i].id == NoNoteID) return NoVoice;
+            }
+        }
+
+        void insert(NoteID id, std::size_t voice) {
+            if (id == NoNoteID) return;
+            std::size_t i = home(id);
+            while (slots[i].id != NoNoteID && slots[i].id != id) i = (i + 1) % Slots;
+            slots[i] = { id, voice };
+        }
+
+        // Only erases when the id still belongs to the voice.
+        void erase(NoteID id, std::size_t voice) {
+            if (id == NoNoteID) return;
+            std::size_t i = home(id);
+            while (slots[i].id != id) {
+                if (slots[i].id == NoNoteID) return;
+                i = (i + 1) % Slots;
+            }
+
+            if (slots[i].voice != voice) return;
+
+            // Backward shift deletion, move later entries of the
+            // probe sequence into the gap so lookups still find them.
+            for (std::size_t j = (i + 1) % Slots; slots[j].id != NoNoteID; j = (j + 1) % Slots) {
+                const std::size_t start = home(slots[j].id);
+                const bool movable = i <= j ? (start <= i || start > j) : (start <= i && start > j);
+                if (movable) slots[i] = slots[j], i = j;
+            }
+            slots[i] = Slot{};
+        }
+
+        void clear() { slots.fill(Slot{}); }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
     template<std::derived_from<Voice> VoiceClass, std::size_t Count>
     class VoiceBank : public ModuleContainer {
     public:
 
         // ------------------------------------------------
 
-        enum class Mode { RoundRobin, Lifo };
+        enum class Mode { RoundRobin, Lifo }; // Order in which free voices are used
+
+        // Which voice to steal when no voice is free. Voices that are
+        // releasing are always stolen before voices that are still pressed.
+        enum class Steal { 
+            Oldest,      // Voice that was released, or triggered, first
+            Quietest,    // Voice with the lowest level()
+            LowestNote,  // Pressed voice with the lowest note, so high notes have priority
+            HighestNote, // Pressed voice with the highest note, so low notes have priority
+        };
 
         // ------------------------------------------------
 
         template<class ...Args>
-        VoiceBank(Args&& ...args) : m_Voices{ std::forward<Args>(args)... } {
-            for (auto& voice : m_Voices) registerModule(voice);
-        }
+        VoiceBank(Args&& ...args) : m_Voices{ std::forward<Args>(args)... } { init(); }
+        VoiceBank() { init(); }
 
-        VoiceBank() { for (auto& voice : m_Voices) registerModule(voice); }
+        ~VoiceBank() { m_WorkerPool->remove(m_Jobs); }
 
         // ------------------------------------------------
 
@@ -38,8 +119,27 @@ namespace Kaixo::Processing {
             }
         }
 
+        void mode(Mode mode) { m_Mode = mode; }
+        void steal(Steal steal) { m_Steal = steal; }
+        void sameNoteReuse(bool v) { m_SameNoteReuse = v; } // Retrigger the voice that is releasing the same note
+        void stealFade(float millis) { m_StealFadeMillis = millis; } // Fade out the sound of a stolen voice to avoid clicks
+
         void alwaysLegato(bool v) { m_AlwaysLegato = v; }
         void threading(bool v) { m_UseThreading = v; }
+        // Only has effect when VoiceClass is a batched_voice, do not call while processing.
+        void batching(bool v) { 
+            m_UseBatching = v;
+            linkBatches();
+        }
+
+        // By default all voice banks share the process wide worker pool. This
+        // switches to a dedicated pool instead, spawns new threads so 
+        // not realtime safe, do not call while processing.
+        void threading(WorkerPool::Settings settings) {
+            m_WorkerPool->remove(m_Jobs);
+            m_WorkerPool = std::make_shared<WorkerPool>(settings);
+            m_WorkerPool->add(m_Jobs);
+        }
 
         // ------------------------------------------------
 
@@ -48,30 +148,27 @@ namespace Kaixo::Processing {
         }
 
         void noteOnMPE(NoteID id, Note note, double velocity, int channel) {
-            auto pick = chooseVoice();
-
-            for (std::size_t i = 0; i < m_History.size(); ++i) {
-                auto& n = m_History[i];
-                if (n.note == note) {
-                    // If note in history and already assigned to voice,
-                    // use that voice instead
-                    if (n.voice != NoVoice) {
-                        pick.voice = n.voice;
-                        pick.phase = Chosen::Sustain;
-                    }
-                    // Remove from history so it can later be added back on top
-                    m_History.erase_index(i);
-                    break;
+            const std::size_t key = noteIndex(note);
+            auto& held = m_Notes[key];
+
+            auto pick = chooseVoice(key);
+
+            if (held.held) {
+                // If note is already held and assigned to voice, use that voice instead
+                if (held.voice != NoVoice) {
+                    pick.voice = held.voice;
+                    pick.phase = Chosen::Sustain;
+                } else {
+                    m_Waiting.remove(key);
                 }
             }
-            // If it is stolen, make sure to remove the voice from the note in the history
-            if (pick.stolen()) {
-                for (std::size_t i = 0; i < m_History.size(); ++i) {
-                    auto& n = m_History[i];
-                    if (n.voice == pick.voice) {
-                        n.voice = NoVoice;
-                        break;
-                    }
+
+            // If a pressed voice is stolen, its note waits for a voice to become available
+            if (pick.phase == Chosen::Sustain && pressed(pick.voice)) {
+                const std::size_t other = noteIndex(m_Voices[pick.voice].note);
+                if (other != key && m_Notes[other].voice == pick.voice) {
+                    unassign(other);
+                    m_Waiting.push_back(other);
                 }
             }
 
@@ -85,12 +182,10 @@ namespace Kaixo::Processing {
                 .stolen = pick.stolen(),
             });
 
-            m_History.push_back(PressedNote{
-                .id = id,
-                .velocity = velocity,
-                .note = note, 
-                .voice = pick.voice
-            });
+            held.held = true;
+            held.id = id;
+            held.velocity = velocity;
+            assign(key, pick.voice);
         }
 
         void noteOff(Note note, double velocity, int channel) {
@@ -98,141 +193,134 @@ namespace Kaixo::Processing {
         }
 
         void noteOffMPE(NoteID id, Note note, double velocity, int channel) {
-            // Remove the note from history
-            for (std::size_t i = 0; i < m_History.size(); ++i) {
-                auto& n = m_History[i];
-                if (n.note == note) {
-                    m_History.erase_index(i);
-                    break;
-                }
-            }
-            // Look for the voice that had this note
-            std::size_t voiceThatHadThisNote = NoVoice;
-            for (std::size_t i = 0; i < m_Voices.size(); ++i) {
-                auto& voice = m_Voices[i];
-                if (voice.pressed && voice.note == note) {
-                    voiceThatHadThisNote = i;
-                    break;
-                }
-            }
-            // Apparently no voice had this note?? Okay well then don't do anything
-            if (voiceThatHadThisNote == NoVoice) return; 
-
-            // Look for notes in history that are not assigned to a voice yet
-            std::size_t canSwitchToNoteFromHistory = npos;
-            for (std::size_t i = 0; i < m_History.size(); ++i) {
-                auto& n = m_History[i];
-                if (n.voice == NoVoice) {
-                    canSwitchToNoteFromHistory = i;
-                    break;
-                }
-            }
+            const std::size_t key = noteIndex(note);
+            auto& held = m_Notes[key];
+            if (!held.held) return;
+
+            held.held = false;
+            m_Waiting.remove(key);
 
-            // Cannot switch to note from history, just release voice
-            if (canSwitchToNoteFromHistory == npos) {
+            // Note was not assigned to a voice, nothing to release
+            const std::size_t voice = held.voice;
+            if (voice == NoVoice) return;
+            unassign(key);
+
+            // Switch to the first note that is still waiting for a voice, or just release
+            const std::size_t waiting = m_Waiting.pop_front();
+            if (waiting == IndexList<Notes>::npos) {
                 release(Release{
-                    .voice = voiceThatHadThisNote,
+                    .voice = voice,
                     .velocity = velocity,
                     .note = note
                 });
             } else {
-                PressedNote n = m_History[canSwitchToNoteFromHistory];
-                m_History.erase_index(canSwitchToNoteFromHistory);
-
+                auto& n = m_Notes[waiting];
                 trigger({
                     .id = n.id,
                     .velocity = n.velocity,
-                    .voice = voiceThatHadThisNote,
-                    .note = n.note,
+                    .voice = voice,
+                    .note = static_cast<Note>(waiting),
                     .channel = channel,
                     .legato = true,
                     .stolen = true,
                 });
 
-                m_History.push_back(PressedNote{
-                    .id = n.id,
-                    .velocity = n.velocity,
-                    .note = n.note,
-                    .voice = voiceThatHadThisNote
-                });
+                assign(waiting, voice);
             }
         }
 
         // ------------------------------------------------
 
         void notePitchBendMPE(NoteID id, double value) {
-            for (auto& voice : m_Voices) {
-                if (voice.id == id) {
-                    voice.notePitchBendMPE(value);
-                }
+            if (std::size_t i = m_NoteIDs.find(id); i != NoVoice) {
+                m_Voices[i].pitchBend.set(value, expressionRampSamples(m_Voices[i]));
+                m_Voices[i].notePitchBendMPE(value);
             }
         }
 
         void notePressureMPE(NoteID id, double value) {
-            for (auto& voice : m_Voices) {
-                if (voice.id == id) {
-                    voice.notePressureMPE(value);
-                }
+            if (std::size_t i = m_NoteIDs.find(id); i != NoVoice) {
+                m_Voices[i].pressure.set(value, expressionRampSamples(m_Voices[i]));
+                m_Voices[i].notePressureMPE(value);
             }
         }
 
         void noteTimbreMPE(NoteID id, double value) {
-            for (auto& voice : m_Voices) {
-                if (voice.id == id) {
-                    voice.noteTimbreMPE(value);
-                }
+            if (std::size_t i = m_NoteIDs.find(id); i != NoVoice) {
+                m_Voices[i].timbre.set(value, expressionRampSamples(m_Voices[i]));
+                m_Voices[i].noteTimbreMPE(value);
             }
         }
 
+        // Time over which the voice's expression values ramp to a new MPE value.
+        void expressionRamp(float millis) { m_ExpressionRampMillis = millis; }
+
         // ------------------------------------------------
 
+        // Renders the whole output buffer, like process().
+        void processBlock(std::size_t) override { process(); }
+
         void process() override {
+            KAIXO_PROFILE_MODULE();
+            KAIXO_TRACE_SCOPE("VoiceBank::process");
+
             updateLastNote();
 
             const std::size_t nofSamplesToGenerate = outputBuffer().size();
 
-            for (auto& voice : m_Voices) {
-                voice.output.prepare(nofSamplesToGenerate);
+            // Work is split into items, which are either a voice, or
+            // a batch of voices when the voice class supports batching.
+            // Only items with an active voice are processed at all.
+            Vector<std::size_t, Count> items{};
+            Vector<std::size_t, Count> voices{};
+            collectActive(items, voices);
+            KAIXO_TRACE_COUNTER("Active voices", voices.size());
+
+            for (std::size_t voice : voices) {
+                m_Voices[voice].output.prepare(nofSamplesToGenerate);
             }
 
-            if (m_UseThreading) {
-                std::future<void> futures[Count]{};
+            // If generating less than 52 samples, do work on main thread always
+            if (m_UseThreading && nofSamplesToGenerate >= 52 && items.size() > 1) {
                 bool onMain[Count]{};
-                int nofVoicesOnMainThread = 0;
-
-                for (int i = 0; i < Count; i++) {
-                    const bool isActive = m_Voices[i].active();
-                    // If generating less than 52 samples, do work on main thread always
-                    if (nofSamplesToGenerate < 52) onMain[i] = true; 
-                    // Always do at least 1 voice on main thread
-                    else if (isActive && nofVoicesOnMainThread < 1) onMain[i] = true, nofVoicesOnMainThread++; 
-                    // If not active, process on main thread because it should not use too much CPU anyway
-                    else if (!isActive) onMain[i] = true; 
-                    // Otherwise send work to threadpool
-                    else futures[i] = m_ThreadPool.push([this, i] { m_Voices[i].process(); }); 
+
+                // Always do the first item on main thread, send the others to the 
+                // worker pool, or do them on main if the group is full.
+                onMain[0] = true;
+                for (std::size_t i = 1; i < items.size(); i++) {
+                    onMain[i] = !m_Jobs.add(Job{ .function = &processItem, .context = this, .index = items[i] });
                 }
 
-                // Process main thread voices
-                for (int i = 0; i < Count; i++) {
+                m_WorkerPool->submit(m_Jobs);
+
+                // Process main thread items
+                for (std::size_t i = 0; i < items.size(); i++) {
                     if (onMain[i]) {
-                        m_Voices[i].process();
-                    }
-                }
-                // Wait for worker threads
-                for (int i = 0; i < Count; i++) {
-                    if (!onMain[i]) {
-                        futures[i].wait();
+                        processItem(this, items[i]);
                     }
                 }
+
+                // Help with remaining jobs, and wait for worker threads
+                m_WorkerPool->wait(m_Jobs);
             } else {
-                for (auto& voice : m_Voices) {
-                    voice.process();
+                for (std::size_t item : items) {
+                    processItem(this, item);
                 }
             }
 
-            for (auto& voice : m_Voices) {
-                for (std::size_t i = 0; i < outputBuffer().size(); ++i) {
-                    outputBuffer()[i] += voice.output[i];
+            for (std::size_t voice : voices) {
+                m_ExpressionStart[voice] = false;
+                if (m_Fades[voice].remaining != 0) fade(voice, nofSamplesToGenerate);
+                outputBuffer().add(m_Voices[voice].output, nofSamplesToGenerate);
+            }
+
+            // Voices that have finished their release are no longer processed
+            for (std::size_t voice : voices) {
+                if (m_Active.test(voice) && !pressed(voice) && !active(voice)) {
+                    m_Active.unset(voice);
+                    m_Releasing.remove(voice);
+                    m_Free.set(voice);
+                    m_Voices[voice].output.prepare(0);
                 }
             }
         }
@@ -278,11 +366,122 @@ namespace Kaixo::Processing {
         
         // ------------------------------------------------
         
-        cxxpool::thread_pool m_ThreadPool{ Count };
+        std::shared_ptr<WorkerPool> m_WorkerPool = WorkerPool::shared();
+
+        JobGroup m_Jobs{};
+
+        // ------------------------------------------------
+
+        // Voices that are pressed, or were still active after the last process.
+        StateVector<std::size_t, Count> m_Active{};
+
+        // ------------------------------------------------
+
+        using Batch = batch_type<VoiceClass>;
+        constexpr static std::size_t Lanes = batch_lanes<VoiceClass>;
+        constexpr static std::size_t Batches = batched_voice<VoiceClass> ? Count / Lanes : 0;
+
+        std::array<Batch, Batches> m_Batches{};
+
+        bool batched() const { return Batches != 0 && m_UseBatching; }
+
+        // ------------------------------------------------
+
+        void init() {
+            for (auto& voice : m_Voices) registerModule(voice);
+
+            m_Free.fill();
+            m_LastVoice.fill(NoVoice);
+
+            if constexpr (Batches != 0) {
+                if constexpr (std::derived_from<Batch, Module>) {
+                    for (auto& batch : m_Batches) registerModule(batch);
+                }
+            }
+
+            linkBatches();
+            m_WorkerPool->add(m_Jobs);
+        }
+
+        // Point the voices that are processed in a batch to their lane.
+        void linkBatches() {
+            if constexpr (Batches != 0) {
+                for (std::size_t i = 0; i < Batches * Lanes; ++i) {
+                    m_Voices[i].batch = batched() ? &m_Batches[i / Lanes] : nullptr;
+                    m_Voices[i].lane = i % Lanes;
+                }
+            }
+        }
+
+        // Items and voices that need to be processed this block. A batch
+        // is processed when any of its lanes is active, including all its voices.
+        void collectActive(Vector<std::size_t, Count>& items, Vector<std::size_t, Count>& voices) {
+            if (batched()) {
+                for (std::size_t i = 0; i < Batches; ++i) {
+                    bool any = false;
+                    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                        any |= m_Active.test(i * Lanes + lane);
+                    }
+
+                    if (!any) continue;
+                    items.push_back(i);
+                    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                        voices.push_back(i * Lanes + lane);
+                    }
+                }
+
+                for (std::size_t i = Batches * Lanes; i < Count; ++i) {
+                    if (!m_Active.test(i)) continue;
+                    items.push_back(i - Batches * Lanes + Batches);
+                    voices.push_back(i);
+                }
+            } else {
+                m_Active.foreach([&](std::size_t i) {
+                    items.push_back(i);
+                    voices.push_back(i);
+                });
+            }
+        }
+
+        static void processItem(void* context, std::size_t i) {
+            VoiceBank& self = *static_cast<VoiceBank*>(context);
+            KAIXO_TRACE_SCOPE("VoiceBank::processItem");
+            if constexpr (Batches != 0) {
+                if (self.batched()) {
+                    if (i >= Batches) {
+                        auto& voice = self.m_Voices[i - Batches + Batches * Lanes];
+#ifdef KAIXO_PROFILE_MODULES
+                        const auto profile = voice.profile();
+#endif
+                        voice.process();
+                    } else {
+                        std::array<VoiceClass*, Lanes> voices;
+                        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                            voices[lane] = &self.m_Voices[i * Lanes + lane];
+                        }
+#ifdef KAIXO_PROFILE_MODULES
+                        // Batches that aren't modules have no node, they only count towards the bank
+                        const auto profile = [&]() -> Profiler::Scope {
+                            if constexpr (std::derived_from<Batch, Module>) return self.m_Batches[i].profile();
+                            else return { nullptr, Profiler::NoNode };
+                        }();
+#endif
+                        self.m_Batches[i].process(voices);
+                    }
+                    return;
+                }
+            }
+            
+#ifdef KAIXO_PROFILE_MODULES
+            const auto profile = self.m_Voices[i].profile();
+#endif
+            self.m_Voices[i].process();
+        }
 
         // ------------------------------------------------
 
         bool m_UseThreading = false;
+        bool m_UseBatching = true;
         bool m_AlwaysLegato = false;
         std::size_t m_MaxVoices = Count;
         std::size_t m_LastTriggered = 0;
@@ -294,14 +493,44 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
-        struct PressedNote {
-            NoteID id;
+        constexpr static std::size_t Notes = 128;
+
+        static std::size_t noteIndex(Note note) {
+            return static_cast<std::size_t>(Math::clamp(note, 0.f, static_cast<float>(Notes - 1)));
+        }
+
+        // ------------------------------------------------
+
+        struct HeldNote {
+            bool held = false;
+            NoteID id = NoNoteID;
             double velocity = 0;
-            Note note = 0;
             std::size_t voice = NoVoice; // Is note actually assigned to voice?
         };
 
-        Vector<PressedNote, 32> m_History;
+        std::array<HeldNote, Notes> m_Notes{};
+        IndexList<Notes> m_Waiting{};     // Held notes that lost their voice, in order
+        IndexSet<Notes> m_Assigned{};     // Held notes that have a voice
+
+        void assign(std::size_t key, std::size_t voice) {
+            m_Notes[key].voice = voice;
+            m_Assigned.set(key);
+        }
+
+        void unassign(std::size_t key) {
+            m_Notes[key].voice = NoVoice;
+            m_Assigned.unset(key);
+        }
+
+        // ------------------------------------------------
+
+        Steal m_Steal = Steal::Oldest;
+        bool m_SameNoteReuse = false;
+
+        IndexSet<Count> m_Free{};         // Voices that are not active
+        IndexList<Count> m_Releasing{};   // Active voices that are released, in order of release
+        IndexList<Count> m_Pressed{};     // Pressed voices, in order of trigger
+        std::array<std::size_t, Notes> m_LastVoice{}; // Last voice that played each note
 
         // ------------------------------------------------
 
@@ -319,29 +548,65 @@ namespace Kaixo::Processing {
 
         // ------------------------------------------------
 
-        Chosen chooseVoice() {
-            auto choose = [&](auto index) {
-                std::size_t chosen = 0;
-                auto find = [&](auto condition) {
-                    for (std::size_t i = 0; i < m_MaxVoices; ++i) {
-                        chosen = index(i);
-                        if (condition(chosen)) return true;
-                    }
-                    return false;
-                };
-                // Prefer non-active voices
-                if (find([&](auto voice) { return !active(voice); }))
-                    return Chosen{ chosen, Chosen::Dead };
-                // Otherwise prefer non-pressed voices (in release mode)
-                if (find([&](auto voice) { return !pressed(voice); }))
-                    return Chosen{ chosen, Chosen::Release };
-                // Finally just pick the next voice if no other available
-                return Chosen{ index(0), Chosen::Sustain};
-            };
+        Chosen chooseVoice(std::size_t key) {
+            // Prefer the voice that is still releasing the same note
+            if (m_SameNoteReuse) {
+                const std::size_t voice = m_LastVoice[key];
+                if (voice < m_MaxVoices && m_Releasing.contains(voice) && noteIndex(m_Voices[voice].note) == key)
+                    return Chosen{ voice, Chosen::Release };
+            }
+
+            // Prefer non-active voices
+            if (std::size_t voice = nextFree(); voice != NoVoice)
+                return Chosen{ voice, Chosen::Dead };
+
+            // Otherwise prefer non-pressed voices (in release mode)
+            if (std::size_t voice = stealFrom(m_Releasing, false); voice != NoVoice)
+                return Chosen{ voice, Chosen::Release };
+
+            // Finally steal a pressed voice
+            if (std::size_t voice = stealFrom(m_Pressed, true); voice != NoVoice)
+                return Chosen{ voice, Chosen::Sustain };
+
+            return Chosen{ 0, Chosen::Sustain };
+        }
 
+        std::size_t nextFree() const {
+            std::size_t voice = NoVoice;
             switch (m_Mode) {
-            case Mode::RoundRobin: return choose([&](std::size_t i) { return (i + m_LastTriggered + 1) % m_MaxVoices; });
-            case Mode::Lifo: return choose([&](std::size_t i) { return i; });
+            case Mode::RoundRobin:
+                voice = m_Free.first(m_LastTriggered + 1);
+                if (voice >= m_MaxVoices) voice = m_Free.first(0);
+                break;
+            case Mode::Lifo:
+                voice = m_Free.first(0);
+                break;
+            }
+            return voice < m_MaxVoices ? voice : NoVoice;
+        }
+
+        std::size_t stealFrom(const IndexList<Count>& list, bool isPressed) const {
+            if (list.empty()) return NoVoice;
+
+            switch (m_Steal) {
+            case Steal::LowestNote:
+            case Steal::HighestNote:
+                // Note priority only applies to pressed voices
+                if (isPressed) {
+                    const std::size_t key = m_Steal == Steal::LowestNote ? m_Assigned.first() : m_Assigned.last();
+                    if (key != IndexSet<Notes>::npos) return m_Notes[key].voice;
+                }
+                return list.front();
+            case Steal::Quietest: {
+                std::size_t quietest = NoVoice;
+                float level = std::numeric_limits<float>::max();
+                list.foreach([&](std::size_t voice) {
+                    const float l = m_Voices[voice].level();
+                    if (l < level) level = l, quietest = voice;
+                });
+                return quietest;
+            }
+            default: return list.front();
             }
         }
 
@@ -351,7 +616,21 @@ namespace Kaixo::Processing {
             m_LastTriggered = 0;
             for (auto& voice : m_Voices) {
                 voice.reset();
+                voice.pressed = false;
             }
+
+            for (std::size_t i = 0; i < Count; ++i) {
+                m_Active.unset(i);
+                m_Fades[i].remaining = 0;
+            }
+
+            for (auto& note : m_Notes) note = HeldNote{};
+            m_NoteIDs.clear();
+            m_Waiting.clear();
+            m_Assigned.clear();
+            m_Releasing.clear();
+            m_Pressed.clear();
+            m_Free.fill();
         }
 
         // ------------------------------------------------
@@ -368,6 +647,24 @@ namespace Kaixo::Processing {
 
         void trigger(Trigger t) {
             auto& voice = m_Voices[t.voice];
+
+            m_NoteIDs.erase(voice.id, t.voice);
+            m_NoteIDs.insert(t.id, t.voice);
+
+            // A new note starts at its initial expression, the Controller sends
+            // those right after the note on, which then should not ramp.
+            if (!t.legato) m_ExpressionStart[t.voice] = true;
+
+            // Stolen voice cuts off its current sound, fade that out instead
+            if (t.stolen && !t.legato && m_StealFadeMillis > 0 && voice.output.size() != 0) {
+                const std::size_t length = Math::max(static_cast<std::size_t>(0.001 * m_StealFadeMillis * sampleRate()), 1ull);
+                m_Fades[t.voice] = StealFade{
+                    .from = voice.output[voice.output.size() - 1],
+                    .remaining = length,
+                    .length = length,
+                };
+            }
+
             voice.id = t.id;
             voice.fromNote = t.legato ? voice.currentNote() : m_AlwaysLegato ? m_LastNote : t.note;
             voice.note = t.note;
@@ -377,6 +674,11 @@ namespace Kaixo::Processing {
             voice.stolen = t.stolen;
             voice.trigger();
             voice.pressed = true;
+            m_Active.set(t.voice);
+            m_Free.unset(t.voice);
+            m_Releasing.remove(t.voice);
+            m_Pressed.push_back(t.voice);
+            m_LastVoice[noteIndex(t.note)] = t.voice;
             m_LastTriggered = t.voice;
         }
 
@@ -390,10 +692,52 @@ namespace Kaixo::Processing {
 
         void release(Release t) {
             auto& voice = m_Voices[t.voice];
+            m_NoteIDs.erase(voice.id, t.voice);
             voice.id = NoNoteID;
             voice.releaseVelocity = t.velocity;
             voice.release();
             voice.pressed = false;
+            m_Pressed.remove(t.voice);
+            m_Releasing.push_back(t.voice);
+        }
+
+        // ------------------------------------------------
+
+        NoteIDMap<Count> m_NoteIDs{};
+
+        // ------------------------------------------------
+
+        float m_ExpressionRampMillis = 5;
+        std::array<bool, Count> m_ExpressionStart{}; // Triggered, but not yet processed
+
+        std::size_t expressionRampSamples(const VoiceClass& voice) const {
+            if (m_ExpressionStart[&voice - m_Voices.data()]) return 0;
+            return static_cast<std::size_t>(0.001 * m_ExpressionRampMillis * sampleRate());
+        }
+
+        // ------------------------------------------------
+
+        struct StealFade {
+            Stereo from{};             // Last output of the stolen sound
+            std::size_t remaining = 0;
+            std::size_t length = 0;
+        };
+
+        float m_StealFadeMillis = 3;
+        std::array<StealFade, Count> m_Fades{};
+
+        // Adds the last value of the stolen sound, fading linearly to 0,
+        // so the step from the old sound to the new one does not click.
+        void fade(std::size_t voice, std::size_t samples) {
+            auto& fade = m_Fades[voice];
+            auto& output = m_Voices[voice].output;
+            const std::size_t n = Math::min(fade.remaining, samples);
+            const float step = 1.f / fade.length;
+            float gain = fade.remaining * step;
+            for (std::size_t i = 0; i < n; ++i, gain -= step) {
+                output[i] += fade.from * gain;
+            }
+            fade.remaining -= n;
         }
 
         // ------------------------------------------------
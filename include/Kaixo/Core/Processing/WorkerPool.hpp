@@ -0,0 +1,287 @@
+#pragma once
+#include "Kaixo/Core/Definitions.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    /**
+     * Bounded lock-free work stealing deque (Chase-Lev). Only the owning
+     * thread may push and pop (from the bottom), any thread may steal
+     * (from the top). Never allocates, so it is safe to use on the audio thread.
+     */
+    template<class Ty, std::size_t Capacity>
+        requires (std::is_trivially_copyable_v<Ty> && (Capacity & (Capacity - 1)) == 0)
+    class WorkStealingQueue {
+    public:
+
+        // ------------------------------------------------
+
+        // Owner only, returns false when full.
+        bool push(const Ty& value) {
+            const std::int64_t b = m_Bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = m_Top.load(std::memory_order_acquire);
+            if (b - t >= static_cast<std::int64_t>(Capacity)) return false;
+            write(b, value);
+            m_Bottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Owner only, returns false when empty.
+        bool pop(Ty& value) {
+            const std::int64_t b = m_Bottom.load(std::memory_order_relaxed) - 1;
+            m_Bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = m_Top.load(std::memory_order_relaxed);
+            if (t > b) { // Empty
+                m_Bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            value = read(b);
+            if (t == b) { // Last element, race against thieves
+                const bool won = m_Top.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_Bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        // Any thread, returns false when empty or when it lost a race.
+        bool steal(Ty& value) {
+            std::int64_t t = m_Top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = m_Bottom.load(std::memory_order_acquire);
+            if (t >= b) return false;
+
+            value = read(t);
+            return m_Top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        // ------------------------------------------------
+
+        bool empty() const {
+            return m_Bottom.load(std::memory_order_acquire)
+                <= m_Top.load(std::memory_order_acquire);
+        }
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::int64_t Mask = static_cast<std::int64_t>(Capacity) - 1;
+        constexpr static std::size_t Words = (sizeof(Ty) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        // A thief may read a slot while the owner overwrites it, after which its steal fails. 
+        // Slots are copied as relaxed atomic words, so that torn read is not a data race.
+        struct Slot {
+            std::array<std::atomic<std::uint64_t>, Words> words{};
+        };
+
+        // ------------------------------------------------
+
+        alignas(64) std::atomic<std::int64_t> m_Top{ 0 };
+        alignas(64) std::atomic<std::int64_t> m_Bottom{ 0 };
+        alignas(64) std::array<Slot, Capacity> m_Data{};
+
+        // ------------------------------------------------
+
+        void write(std::int64_t index, const Ty& value) {
+            std::uint64_t words[Words]{};
+            std::memcpy(words, &value, sizeof(Ty));
+            Slot& slot = m_Data[index & Mask];
+            for (std::size_t i = 0; i < Words; ++i) slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        Ty read(std::int64_t index) const {
+            std::uint64_t words[Words];
+            const Slot& slot = m_Data[index & Mask];
+            for (std::size_t i = 0; i < Words; ++i) words[i] = slot.words[i].load(std::memory_order_relaxed);
+            Ty value;
+            std::memcpy(&value, words, sizeof(Ty));
+            return value;
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    // Type-erased job without captures, so it never allocates.
+    struct Job {
+
+        // ------------------------------------------------
+
+        void(*function)(void* context, std::size_t index) = nullptr;
+        void* context = nullptr;
+        std::size_t index = 0;
+
+        // ------------------------------------------------
+
+        void operator()() const { function(context, index); }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Set of jobs submitted by a single thread (usually the audio thread).
+     * Jobs are pushed onto the group's own deque, workers steal from it, and
+     * the submitting thread helps out by popping from the other end while it waits.
+     */
+    class JobGroup {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t Capacity = 256;
+
+        // ------------------------------------------------
+
+        // Owner only, returns false when full, in which case the job should
+        // be executed directly by the caller.
+        bool add(Job job) {
+            if (!m_Jobs.push(job)) return false;
+            m_Pending.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        bool done() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+        // ------------------------------------------------
+
+    private:
+        WorkStealingQueue<Job, Capacity> m_Jobs{};
+        alignas(64) std::atomic<std::size_t> m_Pending{ 0 };
+
+        // ------------------------------------------------
+
+        bool steal(Job& job) { return m_Jobs.steal(job); }
+        bool pop(Job& job) { return m_Jobs.pop(job); }
+
+        void run(const Job& job) {
+            job();
+            m_Pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        // ------------------------------------------------
+
+        friend class WorkerPool;
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    /**
+     * Persistent pool of pre-spawned worker threads meant for the audio thread.
+     * Workers spin for a while looking for jobs to steal, and only park when
+     * there is no work. Submitting and waiting on a group is lock-free and
+     * does not allocate, workers are only woken through a futex when parked.
+     * 
+     * Multiple groups (e.g. one per plugin instance) can share the same pool, 
+     * workers visit the groups round-robin so no instance starves the others.
+     * Use WorkerPool::shared() to get the process wide pool.
+     */
+    class WorkerPool {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t MaxGroups = 256;
+
+        // ------------------------------------------------
+
+        struct Settings {
+            std::size_t workers = 0;           // Amount of worker threads, 0 for one less than the amount of hardware threads
+            std::uint32_t affinity = 0;        // Bit mask of cores, workers are pinned round-robin over the set bits, 0 to not pin
+            std::size_t spinIterations = 4096; // Amount of failed steal attempts before a worker parks
+        };
+
+        // ------------------------------------------------
+
+        WorkerPool();
+        WorkerPool(Settings settings);
+        ~WorkerPool();
+
+        // ------------------------------------------------
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // ------------------------------------------------
+
+        // Not realtime safe, register groups before processing. When the
+        // pool is full the group is not added, jobs will then all be 
+        // executed by the thread that waits on the group.
+        bool add(JobGroup& group);
+        void remove(JobGroup& group);
+
+        // ------------------------------------------------
+
+        // Wake workers to start stealing from the group, does nothing when it has no jobs.
+        void submit(JobGroup& group);
+
+        // Help executing the group's jobs, and return once all of them have finished.
+        void wait(JobGroup& group);
+
+        void execute(JobGroup& group) { submit(group), wait(group); }
+
+        // ------------------------------------------------
+
+        std::size_t workers() const { return m_Workers.size(); }
+
+        // ------------------------------------------------
+
+        static std::size_t defaultWorkers() {
+            return Math::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        // ------------------------------------------------
+
+        // Process wide pool sized to the hardware, shared by all instances.
+        // Created on first use, and destroyed once the last user releases it.
+        static std::shared_ptr<WorkerPool> shared();
+
+        // ------------------------------------------------
+
+    private:
+        struct Worker {
+            alignas(64) std::atomic<std::uint64_t> scan = 0;
+            std::thread thread{};
+        };
+
+        // ------------------------------------------------
+
+        Settings m_Settings;
+        std::vector<std::unique_ptr<Worker>> m_Workers{};
+        std::array<std::atomic<JobGroup*>, MaxGroups> m_Groups{};
+        std::atomic<std::size_t> m_UsedSlots = 0; // 1 + highest slot ever used, limits scanning
+
+        alignas(64) std::atomic_bool m_Running = true;
+        alignas(64) std::atomic<std::uint32_t> m_Signal = 0;
+        alignas(64) std::atomic<std::size_t> m_Parked = 0;
+
+        // ------------------------------------------------
+
+        void work(std::size_t index);
+        bool tryRunOne(Worker& worker, std::size_t& next);
+        bool hasWork(Worker& worker);
+        void beginScan(Worker& worker);
+        void endScan(Worker& worker);
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
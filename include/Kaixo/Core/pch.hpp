@@ -17,6 +17,8 @@
 #include <algorithm>
 #include <any>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <bitset>
 #include <cassert>
 #include <charconv>
@@ -25,6 +27,7 @@
 #include <complex>
 #include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <expected>
 #include <filesystem>
 #include <format>
@@ -40,9 +43,11 @@
 #include <random>
 #include <ranges>
 #include <set>
+#include <span>
 #include <stack>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <valarray>
@@ -111,6 +116,9 @@ namespace Kaixo {
 #include "Kaixo/Utils/string_literal.hpp"
 #include "Kaixo/Utils/thread_pool.hpp"
 #include "Kaixo/Utils/Containers.hpp"
+#include "Kaixo/Utils/TripleBuffer.hpp"
+#include "Kaixo/Utils/SpscQueue.hpp"
+#include "Kaixo/Utils/InlineFunction.hpp"
 #include "Kaixo/Utils/Random.hpp"
 #include "Kaixo/Utils/Timer.hpp"
 #include "Kaixo/Utils/utils.hpp"
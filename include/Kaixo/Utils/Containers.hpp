@@ -3,6 +3,9 @@
 #include <utility>
 #include <type_traits>
 #include <bitset>
+#include <array>
+#include <bit>
+#include <cstdint>
 
 // ------------------------------------------------
 
@@ -184,6 +187,17 @@ namespace Kaixo {
             for (auto& value : m_Changing) fun(value);
         }
 
+        // Unset all indices for which the predicate returns true, keeps the order.
+        constexpr void unset_if(auto predicate) {
+            std::size_t keep = 0;
+            for (std::size_t i = 0; i < m_Changing.size(); ++i) {
+                const value_type value = m_Changing[i];
+                if (predicate(value)) m_Bits.set(value, false);
+                else m_Changing[keep++] = value;
+            }
+            while (m_Changing.size() > keep) m_Changing.pop_back();
+        }
+
         // ------------------------------------------------
 
     private:
@@ -193,4 +207,134 @@ namespace Kaixo {
         // ------------------------------------------------
 
     };
+
+    // ------------------------------------------------
+
+    // Set of indices in [0, Size) that can find the first and
+    // last index in the set by scanning 64 indices at a time.
+    template<std::size_t Size>
+    class IndexSet {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t npos = static_cast<std::size_t>(-1);
+
+        // ------------------------------------------------
+
+        constexpr bool test(std::size_t i) const { return m_Words[i / 64] & bit(i); }
+        constexpr void set(std::size_t i) { m_Words[i / 64] |= bit(i); }
+        constexpr void unset(std::size_t i) { m_Words[i / 64] &= ~bit(i); }
+
+        constexpr void clear() { m_Words = {}; }
+        constexpr void fill() { for (std::size_t i = 0; i < Size; ++i) set(i); }
+
+        // ------------------------------------------------
+
+        // First index in the set that is at least from, npos if none.
+        constexpr std::size_t first(std::size_t from = 0) const {
+            if (from >= Size) return npos;
+            std::size_t word = from / 64;
+            std::uint64_t bits = m_Words[word] & (~std::uint64_t{ 0 } << (from % 64));
+            while (true) {
+                if (bits != 0) return word * 64 + std::countr_zero(bits);
+                if (++word == Words) return npos;
+                bits = m_Words[word];
+            }
+        }
+
+        // Last index in the set, npos if empty.
+        constexpr std::size_t last() const {
+            for (std::size_t word = Words; word-- > 0;) {
+                if (m_Words[word] != 0) return word * 64 + 63 - std::countl_zero(m_Words[word]);
+            }
+            return npos;
+        }
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::size_t Words = (Size + 63) / 64;
+
+        // ------------------------------------------------
+
+        std::array<std::uint64_t, Words> m_Words{};
+
+        // ------------------------------------------------
+
+        constexpr static std::uint64_t bit(std::size_t i) { return std::uint64_t{ 1 } << (i % 64); }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    // Doubly linked list of indices in [0, Size), keeps insertion order,
+    // and can remove any index in constant time. Each index is in it at most once.
+    template<std::size_t Size>
+    class IndexList {
+    public:
+
+        // ------------------------------------------------
+
+        constexpr static std::size_t npos = static_cast<std::size_t>(-1);
+
+        // ------------------------------------------------
+
+        constexpr IndexList() { clear(); }
+
+        // ------------------------------------------------
+
+        constexpr bool contains(std::size_t i) const { return m_Linked[i]; }
+        constexpr bool empty() const { return m_Next[Size] == Size; }
+
+        constexpr std::size_t front() const { return empty() ? npos : m_Next[Size]; }
+
+        // ------------------------------------------------
+
+        // Moves the index to the back when already in the list.
+        constexpr void push_back(std::size_t i) {
+            remove(i);
+            m_Prev[i] = m_Prev[Size];
+            m_Next[i] = Size;
+            m_Next[m_Prev[Size]] = i;
+            m_Prev[Size] = i;
+            m_Linked[i] = true;
+        }
+
+        constexpr void remove(std::size_t i) {
+            if (!contains(i)) return;
+            m_Next[m_Prev[i]] = m_Next[i];
+            m_Prev[m_Next[i]] = m_Prev[i];
+            m_Linked[i] = false;
+        }
+
+        constexpr std::size_t pop_front() {
+            std::size_t i = front();
+            if (i != npos) remove(i);
+            return i;
+        }
+
+        constexpr void clear() {
+            m_Next[Size] = m_Prev[Size] = Size;
+            m_Linked = {};
+        }
+
+        // ------------------------------------------------
+
+        constexpr void foreach(auto fun) const {
+            for (std::size_t i = m_Next[Size]; i != Size; i = m_Next[i]) fun(i);
+        }
+
+        // ------------------------------------------------
+
+    private:
+        std::array<std::size_t, Size + 1> m_Next{}; // Index Size is the head/tail
+        std::array<std::size_t, Size + 1> m_Prev{};
+        std::array<bool, Size> m_Linked{};
+
+        // ------------------------------------------------
+
+    };
 }
\ No newline at end of file
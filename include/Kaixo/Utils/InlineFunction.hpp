@@ -0,0 +1,103 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ------------------------------------------------
+
+namespace Kaixo {
+
+    // ------------------------------------------------
+
+    /**
+     * Move-only std::function replacement that stores the callable inline.
+     * Callables larger than Size bytes are rejected at compile time, so
+     * constructing, moving and calling it never allocates.
+     */
+    template<class Signature, std::size_t Size = 64>
+    class InlineFunction;
+
+    template<class Result, class ...Args, std::size_t Size>
+    class InlineFunction<Result(Args...), Size> {
+    public:
+
+        // ------------------------------------------------
+
+        InlineFunction() = default;
+
+        template<class Fun>
+            requires (!std::same_as<std::decay_t<Fun>, InlineFunction>
+                && std::is_invocable_r_v<Result, std::decay_t<Fun>&, Args...>)
+        InlineFunction(Fun&& fun) {
+            using Type = std::decay_t<Fun>;
+            static_assert(sizeof(Type) <= Size, "Callable does not fit in the InlineFunction");
+            static_assert(alignof(Type) <= alignof(std::max_align_t), "Callable is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<Type>, "Callable must be nothrow movable");
+
+            new (m_Storage) Type{ std::forward<Fun>(fun) };
+            m_Invoke = [](void* self, Args... args) -> Result {
+                return (*static_cast<Type*>(self))(std::forward<Args>(args)...);
+            };
+
+            if constexpr (!std::is_trivially_copyable_v<Type>) {
+                m_Manage = [](void* self, void* to) {
+                    if (to) new (to) Type{ std::move(*static_cast<Type*>(self)) };
+                    static_cast<Type*>(self)->~Type();
+                };
+            }
+        }
+
+        InlineFunction(InlineFunction&& other) noexcept { take(other); }
+        InlineFunction& operator=(InlineFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                take(other);
+            }
+            return *this;
+        }
+
+        InlineFunction(const InlineFunction&) = delete;
+        InlineFunction& operator=(const InlineFunction&) = delete;
+
+        ~InlineFunction() { reset(); }
+
+        // ------------------------------------------------
+
+        Result operator()(Args... args) { return m_Invoke(m_Storage, std::forward<Args>(args)...); }
+
+        explicit operator bool() const { return m_Invoke != nullptr; }
+
+        // ------------------------------------------------
+
+        void reset() {
+            if (m_Manage) m_Manage(m_Storage, nullptr);
+            m_Invoke = nullptr;
+            m_Manage = nullptr;
+        }
+
+        // ------------------------------------------------
+
+    private:
+        alignas(std::max_align_t) std::byte m_Storage[Size]{};
+        Result(*m_Invoke)(void*, Args...) = nullptr;
+        void(*m_Manage)(void* self, void* to) = nullptr; // Move to 'to' (when not null) and destroy self
+
+        // ------------------------------------------------
+
+        void take(InlineFunction& other) {
+            if (other.m_Manage) other.m_Manage(other.m_Storage, m_Storage);
+            else std::memcpy(m_Storage, other.m_Storage, Size);
+            m_Invoke = std::exchange(other.m_Invoke, nullptr);
+            m_Manage = std::exchange(other.m_Manage, nullptr);
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// ------------------------------------------------
+
+namespace Kaixo {
+
+    // ------------------------------------------------
+
+    /**
+     * Bounded lock-free single producer, single consumer queue. Elements live
+     * in a fixed array, so pushing and popping never allocate, and everything
+     * the producer did before a push is visible to the consumer after the pop.
+     */
+    template<class Ty, std::size_t Capacity>
+        requires ((Capacity & (Capacity - 1)) == 0)
+    class SpscQueue {
+    public:
+
+        // ------------------------------------------------
+
+        // Producer only, returns false when full.
+        bool push(Ty value) {
+            const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+            if (tail - m_Head.load(std::memory_order_acquire) >= Capacity) return false;
+            m_Data[tail & Mask] = std::move(value);
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only, returns false when empty.
+        bool pop(Ty& value) {
+            const std::size_t head = m_Head.load(std::memory_order_relaxed);
+            if (head == m_Tail.load(std::memory_order_acquire)) return false;
+            value = std::move(m_Data[head & Mask]);
+            m_Head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // ------------------------------------------------
+
+        // Approximate when called while the other side is active.
+        std::size_t size() const {
+            return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::size_t Mask = Capacity - 1;
+
+        // ------------------------------------------------
+
+        alignas(64) std::atomic<std::size_t> m_Head{ 0 };
+        alignas(64) std::atomic<std::size_t> m_Tail{ 0 };
+        alignas(64) std::array<Ty, Capacity> m_Data{};
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,121 @@
+
+// ------------------------------------------------
+
+#pragma once
+
+// ------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+// ------------------------------------------------
+
+namespace Kaixo {
+
+    // ------------------------------------------------
+
+    /**
+     * Realtime safe event recorder, for finding out what the audio thread
+     * was doing when a dropout happened. Every thread writes fixed size events
+     * into its own lock-free ring buffer, a background thread drains them into
+     * a Chrome trace-event JSON file (open it in chrome://tracing or Perfetto).
+     *
+     * Recording is off until start() is called, until then every event is a
+     * single relaxed load. Names must be string literals, only the pointer is
+     * recorded. When a ring buffer is full events are dropped, not waited on,
+     * and threads beyond MaxThreads are rejected, both are reported in the file.
+     * Setting the KAIXO_TRACE environment variable to a file path starts
+     * recording when the first plugin instance is created.
+     */
+    class Trace {
+    public:
+
+        // ------------------------------------------------
+
+        using clock = std::chrono::steady_clock;
+
+        constexpr static std::size_t MaxThreads = 64; // Threads recording at the same time
+        constexpr static std::size_t Capacity = 2048; // Events per thread
+        constexpr static std::size_t PayloadSize = 32; // Including the null terminator
+
+        // ------------------------------------------------
+
+        enum class Type : std::uint8_t { Begin, End, Instant, Counter };
+
+        struct Event {
+            const char* name = nullptr;
+            std::int64_t nanos = 0; // Steady clock
+            double value = 0;       // Counters only
+            Type type = Type::Instant;
+            char payload[PayloadSize]{}; // Instant events only
+        };
+
+        // ------------------------------------------------
+
+        class Scope {
+        public:
+            Scope(const char* name) : m_Name(name) { begin(m_Name); }
+            ~Scope() { end(m_Name); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            const char* m_Name;
+        };
+
+        // ------------------------------------------------
+
+        // Not realtime safe, returns false when already recording or the file can't be opened.
+        static bool start(const std::filesystem::path& path);
+
+        // Not realtime safe, writes the remaining events and closes the file.
+        static void stop();
+
+        static bool enabled() { return m_Enabled.load(std::memory_order_relaxed); }
+
+        // ------------------------------------------------
+
+        // Any thread, never blocks or allocates.
+        static void begin(const char* name) { if (enabled()) record(Type::Begin, name); }
+        static void end(const char* name) { if (enabled()) record(Type::End, name); }
+        static void counter(const char* name, double value) { if (enabled()) record(Type::Counter, name, value); }
+
+        // Payload is truncated to fit the event.
+        static void instant(const char* name, std::string_view payload = {}) {
+            if (enabled()) record(Type::Instant, name, 0, payload);
+        }
+
+        // Any thread, name shown for the calling thread, must be a string literal.
+        static void threadName(const char* name);
+
+        // ------------------------------------------------
+
+    private:
+        static inline std::atomic<bool> m_Enabled = false;
+
+        // ------------------------------------------------
+
+        static void record(Type type, const char* name, double value = 0, std::string_view payload = {});
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+#define KAIXO_TRACE_CONCAT_IMPL(a, b) a##b
+#define KAIXO_TRACE_CONCAT(a, b) KAIXO_TRACE_CONCAT_IMPL(a, b)
+#define KAIXO_TRACE_SCOPE(name) const ::Kaixo::Trace::Scope KAIXO_TRACE_CONCAT(_kaixoTraceScope, __LINE__){ name }
+#define KAIXO_TRACE_COUNTER(name, value) ::Kaixo::Trace::counter(name, static_cast<double>(value))
+#define KAIXO_TRACE_INSTANT(name, ...) ::Kaixo::Trace::instant(name __VA_OPT__(,) __VA_ARGS__)
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// ------------------------------------------------
+
+namespace Kaixo {
+
+    // ------------------------------------------------
+
+    /**
+     * Lock-free single producer, single consumer triple buffer. The writer fills
+     * the back buffer and publishes it, the reader picks up the latest published
+     * buffer when it wants to. Neither side ever waits on the other, and the
+     * buffers are never freed, so the reader side is realtime safe.
+     */
+    template<class Ty>
+    class TripleBuffer {
+    public:
+
+        // ------------------------------------------------
+
+        // Writer only, buffer that is not seen by the reader.
+        Ty& back() { return m_Buffers[m_Back]; }
+
+        // Writer only, make the back buffer the latest buffer.
+        void publish() {
+            m_Back = m_Middle.exchange(m_Back | Fresh, std::memory_order_acq_rel) & Index;
+        }
+
+        // ------------------------------------------------
+
+        // Reader only, switch to the latest published buffer, returns true when it changed.
+        bool update() {
+            if ((m_Middle.load(std::memory_order_relaxed) & Fresh) == 0) return false;
+            m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & Index;
+            return true;
+        }
+
+        // Reader only, buffer the reader currently uses.
+        Ty& front() { return m_Buffers[m_Front]; }
+        const Ty& front() const { return m_Buffers[m_Front]; }
+
+        // ------------------------------------------------
+
+        // Set all buffers, neither side may use the buffer meanwhile.
+        void reset(const Ty& value) {
+            for (auto& buffer : m_Buffers) buffer = value;
+            m_Middle.store(m_Middle.load(std::memory_order_relaxed) & Index, std::memory_order_release);
+        }
+
+        // ------------------------------------------------
+
+    private:
+        constexpr static std::uint8_t Index = 0b011;
+        constexpr static std::uint8_t Fresh = 0b100;
+
+        // ------------------------------------------------
+
+        std::array<Ty, 3> m_Buffers{};
+        std::uint8_t m_Back = 0;
+        std::uint8_t m_Front = 1;
+        alignas(64) std::atomic<std::uint8_t> m_Middle = 2;
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,386 @@
+// ------------------------------------------------
+
+#include "Kaixo/Core/Definitions.hpp"
+#include "Kaixo/Core/Controller.hpp"
+#include "Kaixo/Core/Processing/Resampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Render {
+
+    // ------------------------------------------------
+
+    struct Settings {
+        std::vector<std::filesystem::path> presets{};
+        std::vector<std::filesystem::path> midi{};
+        std::filesystem::path output = ".";
+        double sampleRate = 48000;
+        double outputRate = 0;   // Sample rate of the written file, 0 writes at the render sample rate
+        std::size_t blockSize = 512;
+        double tail = 2;         // Seconds rendered after the last midi event
+        int bitDepth = 24;
+        std::size_t jobs = 0;    // 0 uses all cores
+        std::filesystem::path trace{}; // Chrome trace-event file, see Trace
+    };
+
+    struct Job {
+        std::filesystem::path preset{};
+        std::filesystem::path midi{};
+        std::filesystem::path output{};
+        std::string report{}; // CPU usage per module, when profiling is enabled
+    };
+
+    // ------------------------------------------------
+
+    // Host position for offline rendering, the transport is always playing.
+    class PlayHead : public juce::AudioPlayHead {
+    public:
+
+        // ------------------------------------------------
+
+        double bpm = 128;
+        std::int64_t timeInSamples = 0;
+        double sampleRate = 48000;
+
+        // ------------------------------------------------
+
+        juce::Optional<PositionInfo> getPosition() const override {
+            PositionInfo info{};
+            info.setIsPlaying(true);
+            info.setBpm(bpm);
+            info.setTimeInSamples(timeInSamples);
+            info.setTimeInSeconds(timeInSamples / sampleRate);
+            info.setPpqPosition(timeInSamples / sampleRate * bpm / 60.);
+            return info;
+        }
+
+        // ------------------------------------------------
+
+    };
+
+    // ------------------------------------------------
+
+    // All tracks merged into one sequence, with timestamps in seconds.
+    std::optional<juce::MidiMessageSequence> readMidi(const std::filesystem::path& path, double& bpm) {
+        juce::FileInputStream stream{ juce::File{ path.string() } };
+        if (!stream.openedOk()) return {};
+
+        juce::MidiFile file;
+        if (!file.readFrom(stream)) return {};
+
+        juce::MidiMessageSequence tempo;
+        file.findAllTempoEvents(tempo);
+        if (tempo.getNumEvents() > 0) {
+            bpm = 60. / tempo.getEventPointer(0)->message.getTempoSecondsPerQuarterNote();
+        }
+
+        file.convertTimestampTicksToSeconds();
+
+        juce::MidiMessageSequence result;
+        for (int i = 0; i < file.getNumTracks(); ++i) {
+            result.addSequence(*file.getTrack(i), 0);
+        }
+
+        result.updateMatchedPairs();
+        return result;
+    }
+
+    // ------------------------------------------------
+
+#ifdef KAIXO_PROFILE_MODULES
+    // Statistics of the last profiling window, indented by module hierarchy.
+    std::string profile(Controller& controller) {
+        auto* interface = controller.interface<Processing::ProfilerInterface>();
+        if (!interface) return {};
+
+        auto entries = interface->entries();
+        std::vector<std::size_t> depth(entries.size(), 0);
+        std::string report = std::format("{:<40} {:>10} {:>10} {:>10} {:>10} {:>8}\n", 
+            "Module", "ns/sample", "self", "p99", "max", "% CPU");
+
+        for (std::uint32_t i = 0; i < entries.size(); ++i) {
+            auto& entry = entries[i];
+            if (entry.parent != Processing::Profiler::NoNode) depth[i] = depth[entry.parent] + 1;
+            if (entry.maxNanosPerSample == 0) continue; // Never ran
+
+            auto name = std::string(2 * depth[i], ' ') + std::string{ interface->name(i) };
+            report += std::format("{:<40} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>8.2f}\n", name,
+                entry.nanosPerSample, entry.selfNanosPerSample, entry.p99NanosPerSample,
+                entry.maxNanosPerSample, entry.percentCPU);
+        }
+
+        return report;
+    }
+#endif
+
+    // ------------------------------------------------
+
+    bool render(Job& job, const Settings& settings) {
+
+        // ------------------------------------------------
+
+        double bpm = 128;
+        auto sequence = readMidi(job.midi, bpm);
+        if (!sequence) {
+            std::cerr << "Failed to read midi file [" << job.midi << "]\n";
+            return false;
+        }
+
+        // ------------------------------------------------
+
+        // The theme is global, so controllers are not constructed concurrently
+        static std::mutex construct;
+        std::unique_ptr<Controller> controller;
+        {
+            std::lock_guard lock{ construct };
+            controller.reset(createController());
+        }
+
+        // ------------------------------------------------
+
+        const int blockSize = static_cast<int>(settings.blockSize);
+        const int channels = Math::max(controller->getTotalNumInputChannels(), controller->getTotalNumOutputChannels());
+
+        PlayHead playHead;
+        playHead.bpm = bpm;
+        playHead.sampleRate = settings.sampleRate;
+
+        controller->setPlayHead(&playHead);
+        controller->setNonRealtime(true);
+        controller->setRateAndBufferSizeDetails(settings.sampleRate, blockSize);
+        controller->prepareToPlay(settings.sampleRate, blockSize);
+        controller->loadPreset(job.preset);
+
+        // ------------------------------------------------
+
+        juce::File outputFile{ job.output.string() };
+        outputFile.deleteFile();
+
+        juce::WavAudioFormat format;
+        const double outputRate = settings.outputRate > 0 ? settings.outputRate : settings.sampleRate;
+        std::unique_ptr<juce::AudioFormatWriter> writer{ format.createWriterFor(
+            new juce::FileOutputStream{ outputFile }, outputRate, 2, settings.bitDepth, {}, 0) };
+
+        if (!writer) {
+            std::cerr << "Failed to open output file [" << job.output << "]\n";
+            return false;
+        }
+
+        // ------------------------------------------------
+
+        const double end = sequence->getEndTime() + settings.tail;
+        const auto length = static_cast<std::int64_t>(std::ceil(end * settings.sampleRate));
+
+        juce::AudioBuffer<float> buffer{ channels, blockSize };
+        juce::MidiBuffer midi;
+        int event = 0;
+
+        // ------------------------------------------------
+
+        // Converts to the output rate when it differs, dropping the resampler latency.
+        const bool convert = outputRate != settings.sampleRate;
+        Processing::Resampler resampler;
+        resampler.samplerate.in = settings.sampleRate;
+        resampler.samplerate.out = outputRate;
+
+        std::vector<Processing::Stereo> input(blockSize);
+        std::vector<Processing::Stereo> converted(blockSize);
+        juce::AudioBuffer<float> output{ 2, blockSize };
+        auto skip = static_cast<std::size_t>(std::round(resampler.latency() * outputRate / settings.sampleRate));
+
+        auto write = [&](std::span<const Processing::Stereo> samples) {
+            while (!samples.empty()) {
+                auto result = resampler.process(samples, converted);
+                samples = samples.subspan(result.consumed);
+
+                const std::size_t skipped = Math::min(skip, result.produced);
+                skip -= skipped;
+
+                const int count = static_cast<int>(result.produced - skipped);
+                for (int i = 0; i < count; ++i) {
+                    output.setSample(0, i, converted[skipped + i].l);
+                    output.setSample(1, i, converted[skipped + i].r);
+                }
+
+                writer->writeFromAudioSampleBuffer(output, 0, count);
+            }
+        };
+
+        for (std::int64_t start = 0; start < length; start += blockSize) {
+            const int samples = static_cast<int>(std::min<std::int64_t>(blockSize, length - start));
+
+            midi.clear();
+            for (; event < sequence->getNumEvents(); ++event) {
+                const auto& message = sequence->getEventPointer(event)->message;
+                const auto position = static_cast<std::int64_t>(message.getTimeStamp() * settings.sampleRate);
+                if (position >= start + samples) break;
+                if (message.isMetaEvent()) continue;
+                midi.addEvent(message, static_cast<int>(std::max<std::int64_t>(position - start, 0)));
+            }
+
+            buffer.setSize(channels, samples, false, false, true);
+            buffer.clear();
+
+            playHead.timeInSamples = start;
+            controller->processBlock(buffer, midi);
+
+            if (convert) {
+                for (int i = 0; i < samples; ++i) {
+                    input[i] = { buffer.getSample(0, i), buffer.getSample(1 % channels, i) };
+                }
+
+                write({ input.data(), static_cast<std::size_t>(samples) });
+            } else {
+                writer->writeFromAudioSampleBuffer(buffer, 0, samples);
+            }
+        }
+
+        // Flush the samples still in the resampler
+        if (convert) {
+            std::ranges::fill(input, Processing::Stereo{ 0, 0 });
+            const auto flush = static_cast<std::size_t>(std::ceil(resampler.latency()));
+            for (std::size_t done = 0; done < flush; done += input.size()) {
+                write({ input.data(), Math::min(input.size(), flush - done) });
+            }
+        }
+
+        // ------------------------------------------------
+
+#ifdef KAIXO_PROFILE_MODULES
+        job.report = profile(*controller);
+#endif
+
+        controller->releaseResources();
+        return true;
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+    // Every preset is rendered with every midi file, jobs are spread over the cores.
+    int run(const Settings& settings) {
+
+        // ------------------------------------------------
+
+        std::vector<Job> jobs;
+        for (auto& preset : settings.presets) {
+            for (auto& midi : settings.midi) {
+                auto name = preset.stem().string() + " - " + midi.stem().string() + ".wav";
+                jobs.push_back({ .preset = preset, .midi = midi, .output = settings.output / name });
+            }
+        }
+
+        std::filesystem::create_directories(settings.output);
+
+        // ------------------------------------------------
+
+        std::size_t threads = settings.jobs != 0 ? settings.jobs : std::thread::hardware_concurrency();
+        threads = Math::clamp(threads, std::size_t{ 1 }, jobs.size());
+
+        std::atomic<std::size_t> next = 0;
+        std::atomic<std::size_t> failed = 0;
+        std::mutex print;
+
+        auto worker = [&] {
+            for (std::size_t i = next++; i < jobs.size(); i = next++) {
+                bool success = render(jobs[i], settings);
+                if (!success) ++failed;
+
+                std::lock_guard lock{ print };
+                std::cout << (success ? "Rendered [" : "Failed [") << jobs[i].output.string() << "]\n";
+                std::cout << jobs[i].report;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (std::size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+        worker();
+        for (auto& thread : pool) thread.join();
+
+        // ------------------------------------------------
+
+        return failed == 0 ? 0 : 1;
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+    std::optional<Settings> parse(std::vector<std::string_view>& args) {
+        Settings settings;
+
+        // ------------------------------------------------
+
+        for (std::size_t i = 1; i < args.size(); ++i) {
+            std::string_view arg = args[i];
+            if (i + 1 == args.size()) return {}; // Every option has a value
+
+            std::string_view value = args[++i];
+            if (arg == "--preset") settings.presets.emplace_back(value);
+            else if (arg == "--midi") settings.midi.emplace_back(value);
+            else if (arg == "--output") settings.output = value;
+            else if (arg == "--sample-rate") settings.sampleRate = std::stod(std::string{ value });
+            else if (arg == "--output-rate") settings.outputRate = std::stod(std::string{ value });
+            else if (arg == "--block-size") settings.blockSize = std::stoull(std::string{ value });
+            else if (arg == "--tail") settings.tail = std::stod(std::string{ value });
+            else if (arg == "--bit-depth") settings.bitDepth = std::stoi(std::string{ value });
+            else if (arg == "--jobs") settings.jobs = std::stoull(std::string{ value });
+            else if (arg == "--trace") settings.trace = value;
+            else return {};
+        }
+
+        // ------------------------------------------------
+
+        if (settings.presets.empty() || settings.midi.empty()) return {};
+        if (settings.blockSize == 0 || settings.sampleRate <= 0 || settings.outputRate < 0) return {};
+
+        return settings;
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
+
+int main(const int argc, char const* const* const argv) {
+
+    // ------------------------------------------------
+
+    std::vector<std::string_view> args{ argv, std::next(argv, static_cast<std::ptrdiff_t>(argc)) };
+
+    using namespace Kaixo::Render;
+
+    auto settings = parse(args);
+    if (!settings) {
+        std::cerr << "Usage: Render --preset <file> [--preset <file>...] --midi <file> [--midi <file>...]\n"
+                     "              [--output <directory>] [--sample-rate 48000] [--block-size 512]\n"
+                     "              [--tail <seconds>] [--bit-depth 24] [--jobs <threads>]\n"
+                     "              [--output-rate <sample rate>] [--trace <file>]\n";
+        return 1;
+    }
+
+    // ------------------------------------------------
+
+    juce::ScopedJuceInitialiser_GUI initialiser;
+
+    if (!settings->trace.empty() && !Kaixo::Trace::start(settings->trace)) {
+        std::cerr << "Failed to open trace file [" << settings->trace << "]\n";
+        return 1;
+    }
+
+    int result = run(settings.value());
+    Kaixo::Trace::stop();
+    return result;
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -27,11 +27,22 @@ namespace Kaixo {
 
         // ------------------------------------------------
 
+        if (const char* _trace = std::getenv("KAIXO_TRACE")) Trace::start(_trace);
+
+        // ------------------------------------------------
+
         constexpr std::size_t count = Kaixo::nofParameters();
         m_Processor->m_ParameterValues.resize(count, -1);
+#ifdef KAIXO_PROFILE_MODULES
+        m_Processor->m_Profiler = &m_Profiler;
+        m_Processor->m_ProfileNode = m_Profiler.create("Processor", Processing::Profiler::NoNode);
+#endif
         m_Processor->setController(this);
+#ifdef KAIXO_PROFILE_MODULES
+        m_Profiler.allocate();
+#endif
         for (ParamID i = 0; i < count; ++i) {
-            addParameter(m_Parameters.emplace_back(new Parameter{ Kaixo::parameter(i) }));
+            addParameter(m_Parameters.emplace_back(new Parameter{ Kaixo::parameter(i), &m_ParameterChanges }));
             m_Processor->receiveParameterValue(i, m_Parameters[i]->value());
         }
 
@@ -67,6 +78,11 @@ namespace Kaixo {
         m_Output.reserve(samplesPerBlock);
 
         m_Processor->prepare(sampleRate, samplesPerBlock);
+        setLatencySamples(static_cast<int>(std::round(m_Processor->latency())));
+
+#ifdef KAIXO_PROFILE_MODULES
+        m_Profiler.prepare(sampleRate);
+#endif
     }
 
     // ------------------------------------------------
@@ -80,6 +96,19 @@ namespace Kaixo {
 
     void Controller::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
         juce::ScopedNoDenormals noDenormals;
+        Trace::threadName("Audio");
+        KAIXO_TRACE_SCOPE("processBlock");
+        KAIXO_TRACE_COUNTER("Block size", buffer.getNumSamples());
+
+        // ------------------------------------------------
+        
+        // Async tasks from the UI go first, so the whole block sees their changes
+        {
+            KAIXO_TRACE_SCOPE("Interface::execute");
+            for (auto& [type, interface] : m_Processor->m_Interfaces) {
+                interface->execute();
+            }
+        }
 
         // ------------------------------------------------
 
@@ -98,23 +127,104 @@ namespace Kaixo {
 
         // ------------------------------------------------
         
-        for (auto& [type, interface] : m_Processor->m_Interfaces) {
-            interface->execute();
-        }
+        m_ParameterChanges.consume(ParameterChanges::Consumer::Audio, [&](ParamID id) {
+            m_Processor->receiveParameterValue(id, m_Parameters[id]->value());
+        });
 
         // ------------------------------------------------
-        
-        for (std::size_t i = 0; i < m_Parameters.size(); ++i)
-            m_Processor->receiveParameterValue(i, m_Parameters[i]->value());
+
+        auto _numSamples = static_cast<std::size_t>(buffer.getNumSamples());
 
         // ------------------------------------------------
+        
+        // Split the block at the sample position of each midi event, so they are 
+        // applied at their exact offset instead of all at the start of the block.
+        auto _event = midiMessages.cbegin();
+        auto _end = midiMessages.cend();
+        std::size_t _processed = 0;
+        while (_processed < _numSamples) {
+            std::size_t _sliceEnd = _numSamples;
+            for (; _event != _end; ++_event) {
+                const auto _position = static_cast<std::size_t>(Math::max((*_event).samplePosition, 0));
+                if (_position >= _processed + m_MinimumSliceSize && _position < _numSamples) {
+                    _sliceEnd = _position;
+                    break;
+                }
 
-        auto _inputs = getTotalNumInputChannels();
-        auto _outputs = getTotalNumOutputChannels();
+                handleMidiMessage((*_event).getMessage());
+            }
+
+            m_TimeInSamples = _timeInSamples + _processed;
+            renderSlice(buffer, _processed, _sliceEnd - _processed);
+            _processed = _sliceEnd;
+        }
+
+        // Empty blocks still need their events applied
+        for (; _event != _end; ++_event) {
+            handleMidiMessage((*_event).getMessage());
+        }
 
         // ------------------------------------------------
 
-        auto _numSamples = buffer.getNumSamples();
+        for (auto& [type, interface] : m_Processor->m_Interfaces) {
+            interface->publish();
+        }
+
+#ifdef KAIXO_PROFILE_MODULES
+        m_Profiler.endBlock(_numSamples);
+#endif
+    }
+
+    void Controller::handleMidiMessage(const juce::MidiMessage& message) {
+        // Only process midi events when a zone is active
+        if (message.isController() || m_MPEInstrument.getZoneLayout().isActive()) {
+            m_MPEInstrument.processNextMidiEvent(message);
+        } else {
+            if (message.isNoteOn()) {
+                m_Processor->noteOnMPE(NoNoteID, message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
+                return;
+            }
+
+            if (message.isNoteOff()) {
+                m_Processor->noteOffMPE(NoNoteID, message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
+                return;
+            }
+        }
+
+        if (message.isNoteOn()) {
+            m_Processor->noteOn(message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
+            return;
+        }
+
+        if (message.isNoteOff()) {
+            m_Processor->noteOff(message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
+            return;
+        }
+
+        if (message.isControllerOfType(1) && m_ModWheelLinkedParameter != NoParam) {
+            m_Processor->param(m_ModWheelLinkedParameter, message.getControllerValue() / 127.);
+            m_Parameters[m_ModWheelLinkedParameter]->setValue(message.getControllerValue() / 127.);
+            return;
+        }
+
+        if (!m_MPEInstrument.isMemberChannel(message.getChannel())) {
+            if (message.isPitchWheel() && m_PitchWheelLinkedParameter != NoParam) {
+                m_Processor->param(m_PitchWheelLinkedParameter, message.getPitchWheelValue() / 16384.);
+                m_Parameters[m_PitchWheelLinkedParameter]->setValue(message.getPitchWheelValue() / 16384.);
+                return;
+            }
+        }
+
+        if (message.isAftertouch() && m_AftertouchLinkedParameter != NoParam) {
+            m_Processor->param(m_AftertouchLinkedParameter, message.getAfterTouchValue() / 127.);
+            m_Parameters[m_AftertouchLinkedParameter]->setValue(message.getAfterTouchValue() / 127.);
+            return;
+        }
+    }
+
+    void Controller::renderSlice(juce::AudioBuffer<float>& buffer, std::size_t offset, std::size_t samples) {
+        auto _inputs = getTotalNumInputChannels();
+        auto _outputs = getTotalNumOutputChannels();
 
         // ------------------------------------------------
 
@@ -124,90 +234,48 @@ namespace Kaixo {
             m_Input.reserve(0);
             break;
         case 1:
-            m_Input.reserve(_numSamples);
-            for (std::size_t j = 0; j < _numSamples; ++j) {
+            m_Input.reserve(samples);
+            for (std::size_t j = 0; j < samples; ++j) {
                 m_Input[j].l = 
-                m_Input[j].r = _inputData[0][j];
+                m_Input[j].r = _inputData[0][offset + j];
             }
             break;
         case 2:
-            m_Input.reserve(_numSamples);
-            for (std::size_t j = 0; j < _numSamples; ++j) {
-                m_Input[j].l = _inputData[0][j];
-                m_Input[j].r = _inputData[1][j];
+            m_Input.reserve(samples);
+            for (std::size_t j = 0; j < samples; ++j) {
+                m_Input[j].l = _inputData[0][offset + j];
+                m_Input[j].r = _inputData[1][offset + j];
             }
             break;
         }
 
         // ------------------------------------------------
-        
-        for (const auto& raw : midiMessages) {
-            const auto& message = raw.getMessage();
-            // Only process midi events when a zone is active
-            if (message.isController() || m_MPEInstrument.getZoneLayout().isActive()) {
-                m_MPEInstrument.processNextMidiEvent(message);
-            } else {
-                if (message.isNoteOn()) {
-                    m_Processor->noteOnMPE(NoNoteID, message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
-                    continue;
-                }
 
-                if (message.isNoteOff()) {
-                    m_Processor->noteOffMPE(NoNoteID, message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
-                    continue;
-                }
-            }
-
-            if (message.isNoteOn()) {
-                m_Processor->noteOn(message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
-                continue;
-            }
-
-            if (message.isNoteOff()) {
-                m_Processor->noteOff(message.getNoteNumber(), message.getVelocity() / 127., message.getChannel());
-                continue;
-            }
-
-            if (message.isControllerOfType(1) && m_ModWheelLinkedParameter != NoParam) {
-                m_Processor->param(m_ModWheelLinkedParameter, message.getControllerValue() / 127.);
-                m_Parameters[m_ModWheelLinkedParameter]->setValue(message.getControllerValue() / 127.);
-                continue;
-            }
+        m_Output.prepare(samples);
 
-            if (!m_MPEInstrument.isMemberChannel(message.getChannel())) {
-                if (message.isPitchWheel() && m_PitchWheelLinkedParameter != NoParam) {
-                    m_Processor->param(m_PitchWheelLinkedParameter, message.getPitchWheelValue() / 16384.);
-                    m_Parameters[m_PitchWheelLinkedParameter]->setValue(message.getPitchWheelValue() / 16384.);
-                    continue;
-                }
-            }
-
-            if (message.isAftertouch() && m_AftertouchLinkedParameter != NoParam) {
-                m_Processor->param(m_AftertouchLinkedParameter, message.getAfterTouchValue() / 127.);
-                m_Parameters[m_AftertouchLinkedParameter]->setValue(message.getAfterTouchValue() / 127.);
-                continue;
-            }
+        {
+            KAIXO_TRACE_SCOPE("Processor::process");
+#ifdef KAIXO_PROFILE_MODULES
+            const auto _profile = m_Processor->profile();
+#endif
+            // Before any voice reads the routing, they may run on other threads
+            m_Processor->updateModulation();
+            m_Processor->process();
         }
 
         // ------------------------------------------------
 
-        m_Output.prepare(_numSamples);
-
-        m_Processor->process();
-
-        // ------------------------------------------------
-
         float* const* _outputData = buffer.getArrayOfWritePointers();
         switch (_outputs) {
         case 1:
-            for (std::size_t j = 0; j < _numSamples; ++j) {
-                _outputData[0][j] = m_Output[j].average();
+            for (std::size_t j = 0; j < samples; ++j) {
+                _outputData[0][offset + j] = m_Output[j].average();
             }
             break;
         case 2:
-            for (std::size_t j = 0; j < _numSamples; ++j) {
-                _outputData[0][j] = m_Output[j].l;
-                _outputData[1][j] = m_Output[j].r;
+            for (std::size_t j = 0; j < samples; ++j) {
+                _outputData[0][offset + j] = m_Output[j].l;
+                _outputData[1][offset + j] = m_Output[j].r;
             }
             break;
         }
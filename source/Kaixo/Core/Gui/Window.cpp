@@ -146,14 +146,13 @@ namespace Kaixo::Gui {
     // ------------------------------------------------
 
     void Window::timerCallback() {
-        auto count = m_Controller.numParameters();
-        for (ParamID id = 0; id < count; ++id) {
+        m_Controller.m_ParameterChanges.consume(ParameterChanges::Consumer::Gui, [&](ParamID id) {
             auto value = m_Controller.parameter(id).value();
 
             if (value != m_ParameterValues[id]) {
                 notifyParameterChange(id, value);
             }
-        }
+        });
 
         Desktop::getInstance().getMainMouseSource().forceMouseCursorUpdate();
 
@@ -7,22 +7,160 @@ namespace Kaixo::Processing {
     // ------------------------------------------------
 
 #ifdef KAIXO_INTERNAL_MODULATION
+    void ModulationDatabase::set(ParamID id, ModulationSourceID source, float amount) {
+        const Route route{ .param = id, .source = source, .amount = amount };
+        set(std::span{ &route, 1 });
+    }
+
+    void ModulationDatabase::set(std::span<const Route> routes) {
+        std::lock_guard lock{ m_Mutex };
+        for (const Route& route : routes) apply(route);
+        compile();
+    }
+
+    void ModulationDatabase::assign(std::span<const Route> routes) {
+        std::vector<Route> sorted{ routes.begin(), routes.end() };
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Route& a, const Route& b) {
+            return std::pair{ a.param, a.source } < std::pair{ b.param, b.source };
+        });
+
+        // When a route is given multiple times, the last one is used
+        std::vector<Route> result;
+        result.reserve(sorted.size());
+        for (const Route& route : sorted) {
+            if (!result.empty() && result.back().param == route.param && result.back().source == route.source) {
+                result.back() = route;
+            } else {
+                result.push_back(route);
+            }
+        }
+
+        std::erase_if(result, [](const Route& route) { return route.amount == 0; });
+
+        std::lock_guard lock{ m_Mutex };
+        m_Routes = std::move(result);
+        compile();
+    }
+
+    float ModulationDatabase::get(ParamID id, ModulationSourceID source) const {
+        std::lock_guard lock{ m_Mutex };
+        for (auto it = first(id); it != m_Routes.end() && it->param == id; ++it) {
+            if (it->source == source) return it->amount;
+        }
+
+        return 0;
+    }
+
+    std::size_t ModulationDatabase::nofLinkedSource(ParamID id) const {
+        std::lock_guard lock{ m_Mutex };
+        std::size_t count = 0;
+        for (auto it = first(id); it != m_Routes.end() && it->param == id; ++it) ++count;
+        return count;
+    }
+
+    // ------------------------------------------------
+
+    std::vector<ModulationDatabase::Route>::const_iterator ModulationDatabase::first(ParamID id) const {
+        return std::lower_bound(m_Routes.begin(), m_Routes.end(), id,
+            [](const Route& route, ParamID id) { return route.param < id; });
+    }
+
+    void ModulationDatabase::apply(const Route& route) {
+        auto it = std::lower_bound(m_Routes.begin(), m_Routes.end(), std::pair{ route.param, route.source },
+            [](const Route& route, const std::pair<ParamID, ModulationSourceID>& key) {
+                return std::pair{ route.param, route.source } < key;
+            });
+
+        bool exists = it != m_Routes.end() && it->param == route.param && it->source == route.source;
+        if (route.amount == 0) {
+            if (exists) m_Routes.erase(it);
+        } else if (exists) {
+            it->amount = route.amount;
+        } else {
+            m_Routes.insert(it, route);
+        }
+    }
+
+    // ------------------------------------------------
+
+    // Called while locked, so there is only ever one thread writing the back buffer.
+    void ModulationDatabase::compile() {
+        ModulationMatrix& matrix = m_Matrix.back();
+
+        matrix.params.clear();
+        matrix.flags.clear();
+        matrix.offsets.clear();
+        matrix.sources.clear();
+        matrix.inputs.clear();
+        matrix.amounts.clear();
+        matrix.bias.clear();
+        matrix.groups.clear();
+        matrix.row.assign(Parameters, ModulationMatrix::NoRow);
+
+        auto rate = [](ParamID id) { return Math::max(parameter(id).controlRate, std::size_t{ 1 }); };
+
+        // Rows are ordered by control rate, so every group is a range of rows
+        std::vector<ParamID> modulated;
+        for (const Route& route : m_Routes) {
+            const ParameterSettings& settings = parameter(route.param);
+            if (!settings.doModulation() || !settings.doSmoothing()) continue;
+            if (modulated.empty() || modulated.back() != route.param) modulated.push_back(route.param);
+        }
+
+        std::stable_sort(modulated.begin(), modulated.end(), [&](ParamID a, ParamID b) { return rate(a) < rate(b); });
+
+        for (ParamID id : modulated) {
+            const ParameterSettings& settings = parameter(id);
+            const std::uint32_t row = static_cast<std::uint32_t>(matrix.params.size());
+            matrix.row[id] = row;
+            matrix.params.push_back(id);
+            matrix.flags.push_back((settings.multiply ? ModulationMatrix::Multiply : 0)
+                                 | (settings.constrain ? ModulationMatrix::Constrain : 0));
+            matrix.offsets.push_back(static_cast<std::uint32_t>(matrix.amounts.size()));
+
+            if (matrix.groups.empty() || matrix.groups.back().rate != rate(id)) {
+                matrix.groups.push_back({ .rate = rate(id), .first = row, .last = row });
+            }
+
+            matrix.groups.back().last = row + 1;
+
+            for (auto route = first(id); route != m_Routes.end() && route->param == id; ++route) {
+                // Multiplying scales by the normalized source value, but only by the amount,
+                // so the factor is amount * normalized + min(1 - amount, 1)
+                matrix.sources.push_back(route->source);
+                matrix.amounts.push_back(route->amount);
+                if (settings.multiply) {
+                    matrix.inputs.push_back(static_cast<std::uint32_t>(Sources + route->source));
+                    matrix.bias.push_back(Math::min(1 - route->amount, 1.f));
+                } else {
+                    matrix.inputs.push_back(static_cast<std::uint32_t>(route->source));
+                    matrix.bias.push_back(0);
+                }
+            }
+        }
+
+        matrix.offsets.push_back(static_cast<std::uint32_t>(matrix.amounts.size()));
+        matrix.version = ++m_Version;
+        m_Matrix.publish();
+    }
+
+    // ------------------------------------------------
+
     void ModulationDatabase::init() {
-        for (auto& p : m_Modulations) p.clear();
+        assign({});
     }
 
     basic_json ModulationDatabase::serialize() {
+        std::lock_guard lock{ m_Mutex };
         basic_json data = basic_json::object_t();
-        for (ParamID param = 0; param < Parameters; ++param) {
-            if (!modulated(param)) continue;
-            auto& modulations = m_Modulations[param];
+        for (auto it = m_Routes.begin(); it != m_Routes.end();) {
+            const ParamID param = it->param;
             auto& val = getFromIdentifier(data, parameter(param).fullVarName);
             val = basic_json::array_t();
-            for (Entry& mod : modulations) {
+            for (; it != m_Routes.end() && it->param == param; ++it) {
                 basic_json el;
-                ModulationSourceID source = mod.source;
-                el["source"] = std::string{ modulationSource(source).fullVarName };
-                el["amount"] = mod.amount;
+                el["source"] = std::string{ modulationSource(it->source).fullVarName };
+                el["amount"] = it->amount;
                 val.push_back(el);
             }
         }
@@ -31,9 +169,8 @@ namespace Kaixo::Processing {
     }
 
     void ModulationDatabase::deserialize(basic_json& data) {
-        init();
+        std::vector<Route> routes;
         for (ParamID param = 0; param < Parameters; ++param) {
-            auto& modulations = m_Modulations[param];
             auto& val = getFromIdentifier(data, parameter(param).fullVarName);
             if (val.is<basic_json::array_t>()) {
                 auto& arr = val.as<basic_json::array_t>();
@@ -51,17 +188,18 @@ namespace Kaixo::Processing {
                         }
 
                         if (source != NoSource) {
-                            Entry& mod = modulations.emplace_back();
-                            mod.source = source;
-                            mod.amount = el["amount"].as<float>();
+                            routes.push_back(Route{ .param = param, .source = source, .amount = el["amount"].as<float>() });
                         }
                     }
                 }
             }
         }
+
+        // Loading a preset replaces all routing at once
+        assign(routes);
     }
 #endif
 
     // ------------------------------------------------
 
-}
\ No newline at end of file
+}
@@ -1,11 +1,46 @@
 #include "Kaixo/Core/Processing/Module.hpp"
 #include "Kaixo/Core/Controller.hpp"
 
+#if defined(KAIXO_PROFILE_MODULES) && (defined(__GNUC__) || defined(__clang__))
+#include <cxxabi.h>
+#endif
+
 // ------------------------------------------------
 
 namespace Kaixo::Processing {
 
     // ------------------------------------------------
+
+#ifdef KAIXO_PROFILE_MODULES
+    namespace {
+
+        // ------------------------------------------------
+
+        // Name of the module's type without its namespaces, like the "Processor" node.
+        std::string typeName(const Module& module) {
+            std::string name = typeid(module).name();
+#if defined(__GNUC__) || defined(__clang__)
+            int status = 0;
+            std::unique_ptr<char, void(*)(void*)> demangled{ abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status), std::free };
+            if (status == 0) name = demangled.get();
+#else
+            // MSVC names are readable, but prefixed with the kind of type
+            for (std::string_view kind : { "class ", "struct " }) {
+                if (name.starts_with(kind)) name.erase(0, kind.size());
+            }
+#endif
+            // Only strip the qualification of the type itself, not of its template arguments
+            const std::size_t scope = name.rfind("::", name.find('<'));
+            if (scope != std::string::npos) name.erase(0, scope + 2);
+            return name;
+        }
+
+        // ------------------------------------------------
+
+    }
+#endif
+
+    // ------------------------------------------------
     
     Buffer& Module::outputBuffer() const { return m_Controller->m_Output; }
     const Buffer& Module::inputBuffer() const { return m_Controller->m_Input; }
@@ -14,7 +49,7 @@ namespace Kaixo::Processing {
 
     bool Module::offline() const { return m_Controller->m_Offline; }
     double Module::generatingSampleRate() const { return m_Controller->m_SampleRate; }
-    double Module::sampleRate() const { return m_Controller->m_SampleRate * m_Controller->m_Oversample; }
+    double Module::sampleRate() const { return m_Controller->m_SampleRate * m_Controller->m_Oversample * m_Oversample; }
     double Module::bpm() const { return m_Controller->m_Bpm; }
     std::int64_t Module::timeInSamples() const { return m_Controller->m_TimeInSamples; }
 
@@ -22,10 +57,24 @@ namespace Kaixo::Processing {
 
     // ------------------------------------------------
 
+    void ModuleContainer::process() {
+        for (auto& module : m_Modules)
+            module->process();
+    }
+
+    void ModuleContainer::processBlock(std::size_t samples) {
+        for (auto& module : m_Modules)
+            module->processBlock(samples);
+    }
+
+    // ------------------------------------------------
+
     void ModuleContainer::prepare(double sampleRate, std::size_t maxBufferSize) {
         Module::prepare(sampleRate, maxBufferSize);
-        for (auto& module : m_Modules)
+        for (auto& module : m_Modules) {
+            module->m_Oversample = m_Oversample * modulesOversample();
             module->prepare(sampleRate, maxBufferSize);
+        }
     }
 
     void ModuleContainer::reset() {
@@ -43,6 +92,13 @@ namespace Kaixo::Processing {
         return false;
     }
 
+    double ModuleContainer::latency() const {
+        double latency = 0;
+        for (auto& module : m_Modules)
+            latency = Math::max(latency, module->latency());
+        return latency;
+    }
+
     // ------------------------------------------------
 
     void ModuleContainer::param(ParamID id, ParamValue value) {
@@ -53,6 +109,13 @@ namespace Kaixo::Processing {
     void ModuleContainer::setController(Controller* controller) {
         Module::setController(controller);
         for (auto& module : m_Modules) {
+#ifdef KAIXO_PROFILE_MODULES
+            // The profiler nodes follow the module hierarchy
+            if (m_Profiler && module->m_ProfileNode == Profiler::NoNode) {
+                module->m_Profiler = m_Profiler;
+                module->m_ProfileNode = m_Profiler->create(typeName(*module), m_ProfileNode);
+            }
+#endif
             module->setController(controller);
         }
     }
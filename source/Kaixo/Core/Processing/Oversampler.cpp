@@ -0,0 +1,323 @@
+#include "Kaixo/Core/Processing/Oversampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    namespace {
+
+        // ------------------------------------------------
+
+        // Filter per stage, the first stage runs closest to the original rate.
+        struct StageDesign {
+            std::size_t iirCoefficients;
+            double iirTransition;
+            std::size_t firTaps;
+            double firBeta;
+        };
+
+        constexpr StageDesign stageDesigns[Oversampler::MaxStages]{
+            { 12, 0.04, 32, 8.0 },
+            { 6, 0.2, 16, 8.0 },
+            { 4, 0.3, 8, 8.0 },
+            { 4, 0.3, 8, 8.0 },
+        };
+
+        // ------------------------------------------------
+
+        // Modified Bessel function of the first kind, order 0.
+        double bessel0(double x) {
+            double sum = 1;
+            double term = 1;
+            for (std::size_t k = 1; k < 64; ++k) {
+                term *= (x / (2 * k)) * (x / (2 * k));
+                sum += term;
+                if (term < sum * 1e-12) break;
+            }
+            return sum;
+        }
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+    void HalfbandIir::design(std::size_t coefficients, double transition) {
+        m_Sections = Math::min(coefficients, MaxCoefficients) / 2;
+
+        // Jacobi elliptic parameters of the transition band
+        double k = std::tan((1 - transition * 2) * std::numbers::pi / 4);
+        k *= k;
+        const double kksqrt = std::pow(1 - k * k, 0.25);
+        const double e = 0.5 * (1 - kksqrt) / (1 + kksqrt);
+        const double e4 = e * e * e * e;
+        const double q = e * (1 + e4 * (2 + e4 * (15 + 150 * e4)));
+
+        const double order = static_cast<double>(m_Sections * 4 + 1);
+        auto coefficient = [&](std::size_t index) {
+            const double c = static_cast<double>(index + 1);
+
+            double numerator = 0;
+            for (int i = 0, sign = 1; i < 32; ++i, sign = -sign) {
+                const double term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * std::numbers::pi / order) * sign;
+                numerator += term;
+                if (std::abs(term) < 1e-100) break;
+            }
+
+            double denominator = 0.5;
+            for (int i = 1, sign = -1; i < 32; ++i, sign = -sign) {
+                const double term = std::pow(q, i * i) * std::cos(i * 2 * c * std::numbers::pi / order) * sign;
+                denominator += term;
+                if (std::abs(term) < 1e-100) break;
+            }
+
+            const double ww = numerator * std::pow(q, 0.25) / denominator;
+            const double wwsq = ww * ww;
+            const double x = std::sqrt((1 - wwsq * k) * (1 - wwsq / k)) / (1 + wwsq);
+            return (1 - x) / (1 + x);
+        };
+
+        // Even coefficients go to path 0, odd ones to path 1. Each section
+        // delays DC by (1 - c) / (1 + c) samples at the low rate, and path 1
+        // is one more sample late at the high rate.
+        double delay0 = 0;
+        double delay1 = 1;
+        for (std::size_t i = 0; i < m_Sections; ++i) {
+            const double c0 = coefficient(2 * i);
+            const double c1 = coefficient(2 * i + 1);
+            delay0 += 2 * (1 - c0) / (1 + c0);
+            delay1 += 2 * (1 - c1) / (1 + c1);
+
+            m_Coefficients[i][0] = m_Coefficients[i][1] = static_cast<float>(c0);
+            m_Coefficients[i][2] = m_Coefficients[i][3] = static_cast<float>(c1);
+        }
+
+        m_Delay = (delay0 + delay1) / 2;
+        reset();
+    }
+
+    void HalfbandIir::reset() {
+        std::memset(m_X, 0, sizeof(m_X));
+        std::memset(m_Y, 0, sizeof(m_Y));
+    }
+
+    // ------------------------------------------------
+
+    void HalfbandIir::section(float(&lanes)[4]) {
+        for (std::size_t i = 0; i < m_Sections; ++i) {
+            for (std::size_t lane = 0; lane < 4; ++lane) {
+                const float y = (lanes[lane] - m_Y[i][lane]) * m_Coefficients[i][lane] + m_X[i][lane];
+                m_X[i][lane] = lanes[lane];
+                m_Y[i][lane] = y;
+                lanes[lane] = y;
+            }
+        }
+    }
+
+    void HalfbandIir::upsample(const Stereo* in, Stereo* out, std::size_t samples) {
+        for (std::size_t i = 0; i < samples; ++i) {
+            alignas(16) float lanes[4]{ in[i].l, in[i].r, in[i].l, in[i].r };
+            section(lanes);
+            out[2 * i] = { lanes[0], lanes[1] };
+            out[2 * i + 1] = { lanes[2], lanes[3] };
+        }
+    }
+
+    void HalfbandIir::downsample(const Stereo* in, Stereo* out, std::size_t samples) {
+        for (std::size_t i = 0; i < samples; ++i) {
+            alignas(16) float lanes[4]{ in[2 * i + 1].l, in[2 * i + 1].r, in[2 * i].l, in[2 * i].r };
+            section(lanes);
+            out[i] = { 0.5f * (lanes[0] + lanes[2]), 0.5f * (lanes[1] + lanes[3]) };
+        }
+    }
+
+    // ------------------------------------------------
+
+    void HalfbandFir::design(std::size_t taps, double beta) {
+        m_Taps = Math::min(taps, MaxTaps);
+
+        // Tap i sits 2 * i - (taps - 1) samples from the centre, at the high rate
+        const double half = static_cast<double>(m_Taps);
+        double sum = 0;
+        double coefficients[MaxTaps]{};
+        for (std::size_t i = 0; i < m_Taps; ++i) {
+            const double offset = 2. * i - (half - 1);
+            const double x = offset * std::numbers::pi / 2;
+            const double ratio = offset / half;
+            const double window = bessel0(beta * std::sqrt(Math::max(1 - ratio * ratio, 0.))) / bessel0(beta);
+            coefficients[i] = std::sin(x) / x * window;
+            sum += coefficients[i];
+        }
+
+        // The centre tap is 0.5, normalize the rest so DC passes with unity gain
+        for (std::size_t i = 0; i < m_Taps; ++i) {
+            m_Coefficients[2 * i] = m_Coefficients[2 * i + 1] = static_cast<float>(0.5 * coefficients[i] / sum);
+        }
+
+        reset();
+    }
+
+    void HalfbandFir::reset() {
+        for (auto& history : m_History) history = {};
+    }
+
+    // ------------------------------------------------
+
+    const float* HalfbandFir::History::push(Stereo value, std::size_t taps) {
+        write = write + 1 == taps ? 0 : write + 1;
+        data[2 * write] = data[2 * (write + taps)] = value.l;
+        data[2 * write + 1] = data[2 * (write + taps) + 1] = value.r;
+        return &data[2 * (write + 1)];
+    }
+
+    Stereo HalfbandFir::convolve(const float* window) const {
+        // 4 independent accumulators, { left, right, left, right }
+        alignas(16) float sum[4]{};
+        for (std::size_t i = 0; i < 2 * m_Taps; i += 4) {
+            for (std::size_t lane = 0; lane < 4; ++lane) {
+                sum[lane] += m_Coefficients[i + lane] * window[i + lane];
+            }
+        }
+
+        return { sum[0] + sum[2], sum[1] + sum[3] };
+    }
+
+    // ------------------------------------------------
+
+    void HalfbandFir::upsample(const Stereo* in, Stereo* out, std::size_t samples) {
+        const std::size_t centre = 2 * (m_Taps / 2);
+        for (std::size_t i = 0; i < samples; ++i) {
+            const float* window = m_History[0].push(in[i], m_Taps);
+            out[2 * i] = 2 * convolve(window);
+            out[2 * i + 1] = { window[centre], window[centre + 1] };
+        }
+    }
+
+    void HalfbandFir::downsample(const Stereo* in, Stereo* out, std::size_t samples) {
+        const std::size_t centre = 2 * (m_Taps / 2);
+        for (std::size_t i = 0; i < samples; ++i) {
+            const float* even = m_History[1].push(in[2 * i], m_Taps);
+            const float* odd = m_History[0].push(in[2 * i + 1], m_Taps);
+            out[i] = convolve(odd) + 0.5f * Stereo{ even[centre], even[centre + 1] };
+        }
+    }
+
+    // ------------------------------------------------
+
+    void Oversampler::factor(std::size_t n) {
+        std::size_t stages = 0;
+        while ((std::size_t{ 2 } << stages) <= n && stages < MaxStages) ++stages;
+        m_NextStages = stages;
+    }
+
+    // ------------------------------------------------
+
+    void Oversampler::prepare(std::size_t maxBufferSize) {
+        m_Stages = m_NextStages;
+        m_Phase = m_NextPhase;
+
+        for (std::size_t stage = 0; stage < m_Stages; ++stage) {
+            auto& design = stageDesigns[stage];
+            if (m_Phase == Phase::Minimum) {
+                m_IirUp[stage].design(design.iirCoefficients, design.iirTransition);
+                m_IirDown[stage].design(design.iirCoefficients, design.iirTransition);
+            } else {
+                m_FirUp[stage].design(design.firTaps, design.firBeta);
+                m_FirDown[stage].design(design.firTaps, design.firBeta);
+            }
+        }
+
+        for (auto& buffer : m_Buffers) buffer.reserve(maxBufferSize * factor());
+    }
+
+    void Oversampler::reset() {
+        for (std::size_t stage = 0; stage < m_Stages; ++stage) {
+            m_IirUp[stage].reset();
+            m_IirDown[stage].reset();
+            m_FirUp[stage].reset();
+            m_FirDown[stage].reset();
+        }
+    }
+
+    // ------------------------------------------------
+
+    double Oversampler::latency() const {
+        // Downsampling outputs on the odd samples, one high rate sample early
+        double latency = 0;
+        for (std::size_t stage = 0; stage < m_Stages; ++stage) {
+            const double delay = m_Phase == Phase::Minimum
+                ? m_IirUp[stage].delay() + m_IirDown[stage].delay() - 1
+                : m_FirUp[stage].delay() + m_FirDown[stage].delay() - 1;
+            latency += delay / static_cast<double>(std::size_t{ 2 } << stage);
+        }
+        return latency;
+    }
+
+    // ------------------------------------------------
+
+    std::span<Stereo> Oversampler::upsample(std::span<const Stereo> in) {
+        m_Current = 0;
+        if (m_Stages == 0) {
+            std::ranges::copy(in, m_Buffers[0].data());
+            return { m_Buffers[0].data(), in.size() };
+        }
+
+        const Stereo* from = in.data();
+        std::size_t samples = in.size();
+        for (std::size_t stage = 0; stage < m_Stages; ++stage) {
+            m_Current = stage % 2;
+            Stereo* to = m_Buffers[m_Current].data();
+            if (m_Phase == Phase::Minimum) m_IirUp[stage].upsample(from, to, samples);
+            else m_FirUp[stage].upsample(from, to, samples);
+            from = to;
+            samples *= 2;
+        }
+
+        return { m_Buffers[m_Current].data(), samples };
+    }
+
+    std::span<Stereo> Oversampler::buffer(std::size_t samples) {
+        m_Current = 0;
+        return { m_Buffers[0].data(), samples * factor() };
+    }
+
+    void Oversampler::downsample(std::span<Stereo> out) {
+        if (m_Stages == 0) {
+            std::copy_n(m_Buffers[m_Current].data(), out.size(), out.data());
+            return;
+        }
+
+        std::size_t current = m_Current;
+        std::size_t samples = out.size() * factor();
+        for (std::size_t stage = m_Stages; stage-- > 0;) {
+            samples /= 2;
+            const Stereo* from = m_Buffers[current].data();
+            current = 1 - current;
+            Stereo* to = stage == 0 ? out.data() : m_Buffers[current].data();
+            if (m_Phase == Phase::Minimum) m_IirDown[stage].downsample(from, to, samples);
+            else m_FirDown[stage].downsample(from, to, samples);
+        }
+    }
+
+    // ------------------------------------------------
+
+    void Oversampled::prepare(double sampleRate, std::size_t maxBufferSize) {
+        m_Oversampler.prepare(maxBufferSize);
+        ModuleContainer::prepare(sampleRate * factor(), maxBufferSize * factor());
+    }
+
+    void Oversampled::reset() {
+        ModuleContainer::reset();
+        m_Oversampler.reset();
+    }
+
+    double Oversampled::latency() const {
+        return m_Oversampler.latency() + ModuleContainer::latency() / factor();
+    }
+
+    // ------------------------------------------------
+
+}
@@ -1,4 +1,5 @@
 #include "Kaixo/Core/Processing/Processor.hpp"
+#include "Kaixo/Core/Processing/ModulationDatabase.hpp"
 
 // ------------------------------------------------
 
@@ -13,5 +14,13 @@ namespace Kaixo::Processing {
         }
     }
 
+    void Processor::updateModulation() {
+#ifdef KAIXO_INTERNAL_MODULATION
+        for (ModulationDatabase* database : m_ModulationDatabases) {
+            database->update();
+        }
+#endif
+    }
+
     // ------------------------------------------------
 }
\ No newline at end of file
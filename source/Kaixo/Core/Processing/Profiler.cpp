@@ -0,0 +1,127 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Profiler.hpp"
+#include "Kaixo/Core/Processing/Processor.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+#ifdef KAIXO_PROFILE_MODULES
+    std::uint32_t Profiler::create(std::string_view type, std::uint32_t parent) {
+        // Siblings of the same type are numbered, like the voices of a voice bank
+        std::size_t index = 0;
+        for (auto& node : m_Nodes) {
+            if (node.parent == parent && node.type == type) ++index;
+        }
+
+        Node& node = m_Nodes.emplace_back();
+        node.type = type;
+        node.name = index == 0 ? std::string{ type } : std::format("{} {}", type, index);
+        node.parent = parent;
+        return static_cast<std::uint32_t>(m_Nodes.size() - 1);
+    }
+
+    void Profiler::prepare(double sampleRate) {
+        m_SampleRate = sampleRate;
+        m_WindowSamples = 0;
+        for (auto& node : m_Nodes) {
+            node.nanos = 0;
+            node.calls = 0;
+            node.windowNanos = 0;
+            node.written = 0;
+        }
+    }
+
+    void Profiler::allocate() {
+        m_Entries.reset(std::vector<Entry>(m_Nodes.size()));
+    }
+
+    // ------------------------------------------------
+
+    void Profiler::endBlock(std::size_t samples) {
+        if (samples == 0) return;
+
+        for (auto& node : m_Nodes) {
+            const std::uint64_t nanos = node.nanos.exchange(0, std::memory_order_relaxed);
+            if (node.calls.exchange(0, std::memory_order_relaxed) == 0) continue;
+
+            node.windowNanos += nanos;
+            node.history[node.written++ % History] = static_cast<float>(nanos) / samples;
+        }
+
+        m_WindowSamples += samples;
+        if (m_WindowSamples >= m_SampleRate / 4) publish();
+    }
+
+    void Profiler::publish() {
+        auto& entries = m_Entries.back();
+        if (entries.size() != m_Nodes.size() || m_WindowSamples == 0) return;
+
+        const double availableNanosPerSample = 1e9 / m_SampleRate;
+
+        for (std::size_t i = 0; i < m_Nodes.size(); ++i) {
+            Node& node = m_Nodes[i];
+            Entry& entry = entries[i];
+
+            entry.parent = node.parent;
+            entry.nanosPerSample = static_cast<float>(node.windowNanos) / m_WindowSamples;
+            entry.selfNanosPerSample = entry.nanosPerSample;
+            entry.percentCPU = 100 * entry.nanosPerSample / availableNanosPerSample;
+
+            const std::size_t blocks = Math::min(node.written, History);
+            if (blocks == 0) {
+                entry.minNanosPerSample = entry.maxNanosPerSample = entry.p99NanosPerSample = 0;
+            } else {
+                std::copy_n(node.history.begin(), blocks, m_Sorted.begin());
+                const auto end = m_Sorted.begin() + blocks;
+                const auto p99 = m_Sorted.begin() + (blocks * 99) / 100;
+                std::nth_element(m_Sorted.begin(), p99, end);
+                entry.p99NanosPerSample = *p99;
+                entry.minNanosPerSample = *std::min_element(m_Sorted.begin(), end);
+                entry.maxNanosPerSample = *std::max_element(m_Sorted.begin(), end);
+            }
+
+            node.windowNanos = 0;
+            node.written = 0;
+        }
+
+        // Parents are added before their children
+        for (std::size_t i = m_Nodes.size(); i-- > 0;) {
+            if (entries[i].parent != NoNode) {
+                entries[entries[i].parent].selfNanosPerSample -= entries[i].nanosPerSample;
+            }
+        }
+
+        // Children that run in parallel, like voices on the worker pool, can add up to more than their parent
+        for (auto& entry : entries) {
+            entry.selfNanosPerSample = Math::max(entry.selfNanosPerSample, 0.f);
+        }
+
+        m_WindowSamples = 0;
+        m_Entries.publish();
+    }
+
+    // ------------------------------------------------
+
+    std::span<const Profiler::Entry> ProfilerInterface::entries() {
+        Profiler* profiler = self<Processor>().profiler();
+        if (!profiler) return {};
+        return profiler->entries();
+    }
+
+    std::string_view ProfilerInterface::name(std::uint32_t node) {
+        Profiler* profiler = self<Processor>().profiler();
+        if (!profiler || node >= profiler->nodes()) return {};
+        return profiler->name(node);
+    }
+#endif
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
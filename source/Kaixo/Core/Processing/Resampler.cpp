@@ -0,0 +1,176 @@
+#include "Kaixo/Core/Processing/Resampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    // Phases + 1 rows of 'taps' coefficients, the extra row is for interpolating the last phase.
+    struct Resampler::Table {
+        std::size_t taps = 0;
+        std::vector<float> coefficients{};
+
+        const float* row(std::size_t phase) const { return coefficients.data() + phase * taps; }
+    };
+
+    // ------------------------------------------------
+
+    namespace {
+
+        // ------------------------------------------------
+
+        constexpr double Beta = 8; // Kaiser window shape, about 80 dB of stopband attenuation
+
+        // ------------------------------------------------
+
+        // Modified Bessel function of the first kind, order 0.
+        double bessel0(double x) {
+            double sum = 1;
+            double term = 1;
+            for (std::size_t k = 1; k < 64; ++k) {
+                term *= (x / (2 * k)) * (x / (2 * k));
+                sum += term;
+                if (term < sum * 1e-12) break;
+            }
+            return sum;
+        }
+
+        // Fills the polyphase table of a level, returns the amount of taps.
+        std::size_t design(std::size_t level, std::vector<float>& table) {
+            const double cutoff = std::exp2(-static_cast<double>(level) / 4); // Relative to the input Nyquist
+            const std::size_t taps = Math::min(4 * static_cast<std::size_t>(std::ceil(Resampler::Taps / cutoff / 4)), Resampler::MaxTaps);
+            table.resize((Resampler::Phases + 1) * taps);
+
+            // Tap k of phase p sits k + 1 - taps / 2 - p / Phases input samples from the output
+            const double half = taps / 2.;
+            for (std::size_t phase = 0; phase <= Resampler::Phases; ++phase) {
+                const double fraction = static_cast<double>(phase) / Resampler::Phases;
+                float* row = table.data() + phase * taps;
+
+                double sum = 0;
+                double coefficients[Resampler::MaxTaps]{};
+                for (std::size_t k = 0; k < taps; ++k) {
+                    const double time = k + 1 - half - fraction;
+                    const double x = cutoff * time * std::numbers::pi;
+                    const double ratio = time / half;
+                    const double window = bessel0(Beta * std::sqrt(Math::max(1 - ratio * ratio, 0.))) / bessel0(Beta);
+                    coefficients[k] = (x == 0 ? 1 : std::sin(x) / x) * window;
+                    sum += coefficients[k];
+                }
+
+                // Unity gain at DC for every phase
+                for (std::size_t k = 0; k < taps; ++k) {
+                    row[k] = static_cast<float>(coefficients[k] / sum);
+                }
+            }
+
+            return taps;
+        }
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+    const Resampler::Table& Resampler::table(std::size_t level) {
+        static const std::array<Table, Levels> tables = [] {
+            std::array<Table, Levels> result;
+            for (std::size_t i = 0; i < Levels; ++i) result[i].taps = design(i, result[i].coefficients);
+            return result;
+        }();
+        return tables[level];
+    }
+
+    // ------------------------------------------------
+
+    Resampler::Resampler() { table(0); }
+
+    // ------------------------------------------------
+
+    void Resampler::reset() {
+        std::memset(m_Left, 0, sizeof(m_Left));
+        std::memset(m_Right, 0, sizeof(m_Right));
+        m_Write = 0;
+        m_Fraction = 0;
+        m_Pending = 1;
+    }
+
+    // ------------------------------------------------
+
+    Resampler::Result Resampler::process(std::span<const Stereo> in, std::span<Stereo> out) {
+        Result result;
+        while (result.produced < out.size()) {
+            for (; m_Pending > 0; --m_Pending) {
+                if (result.consumed == in.size()) return result;
+                push(in[result.consumed++]);
+            }
+
+            out[result.produced++] = next();
+        }
+
+        return result;
+    }
+
+    // ------------------------------------------------
+
+    void Resampler::push(Stereo sample) {
+        m_Write = m_Write + 1 == MaxTaps ? 0 : m_Write + 1;
+        m_Left[m_Write] = m_Left[m_Write + MaxTaps] = sample.l;
+        m_Right[m_Write] = m_Right[m_Write + MaxTaps] = sample.r;
+    }
+
+    Stereo Resampler::next() {
+        const double ratio = samplerate.in / samplerate.out;
+        if (ratio != m_Ratio) {
+            // Highest cutoff that is still below the output Nyquist
+            m_Ratio = ratio;
+            const std::size_t level = ratio <= 1 ? 0
+                : Math::min(static_cast<std::size_t>(std::ceil(4 * std::log2(ratio) - 1e-9)), Levels - 1);
+            m_Table = &table(level);
+        }
+
+        const Table& table = *m_Table;
+
+        const double position = m_Fraction * Phases;
+        const std::size_t phase = Math::min(static_cast<std::size_t>(position), Phases - 1);
+        const float blend = static_cast<float>(position - phase);
+        const float* from = table.row(phase);
+        const float* to = table.row(phase + 1);
+
+        // Shorter kernels are centred in the window, so the latency does not depend on the level
+        const std::size_t offset = m_Write + 1 + (MaxTaps - table.taps) / 2;
+        const float* left = m_Left + offset;
+        const float* right = m_Right + offset;
+
+        // 4 independent accumulators per channel, every lane loop is one vector operation. The
+        // sums are written back as a whole, otherwise the compiler vectorizes across the taps.
+        alignas(16) float sumLeft[4]{};
+        alignas(16) float sumRight[4]{};
+        for (std::size_t i = 0; i < table.taps; i += 4) {
+            alignas(16) float coefficients[4];
+            alignas(16) float nextLeft[4];
+            alignas(16) float nextRight[4];
+            for (std::size_t lane = 0; lane < 4; ++lane) coefficients[lane] = from[i + lane] + blend * (to[i + lane] - from[i + lane]);
+            for (std::size_t lane = 0; lane < 4; ++lane) nextLeft[lane] = sumLeft[lane] + coefficients[lane] * left[i + lane];
+            for (std::size_t lane = 0; lane < 4; ++lane) nextRight[lane] = sumRight[lane] + coefficients[lane] * right[i + lane];
+            std::memcpy(sumLeft, nextLeft, sizeof(sumLeft));
+            std::memcpy(sumRight, nextRight, sizeof(sumRight));
+        }
+
+        // Advance to the next output
+        m_Fraction += ratio;
+        const double whole = std::floor(m_Fraction);
+        m_Fraction -= whole;
+        m_Pending = static_cast<std::size_t>(whole);
+
+        return {
+            (sumLeft[0] + sumLeft[1]) + (sumLeft[2] + sumLeft[3]),
+            (sumRight[0] + sumRight[1]) + (sumRight[2] + sumRight[3]),
+        };
+    }
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,199 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/WorkerPool.hpp"
+
+// ------------------------------------------------
+
+#include <bit>
+
+// ------------------------------------------------
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KAIXO_CPU_RELAX() _mm_pause()
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define KAIXO_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define KAIXO_CPU_RELAX() std::this_thread::yield()
+#endif
+
+// ------------------------------------------------
+
+namespace Kaixo::Processing {
+
+    // ------------------------------------------------
+
+    WorkerPool::WorkerPool()
+        : WorkerPool(Settings{})
+    {}
+
+    WorkerPool::WorkerPool(Settings settings)
+        : m_Settings(settings)
+    {
+        if (m_Settings.workers == 0) m_Settings.workers = defaultWorkers();
+
+        for (auto& group : m_Groups) group.store(nullptr);
+
+        // Create all workers before starting any thread, 
+        // as the threads access the worker list.
+        for (std::size_t i = 0; i < m_Settings.workers; ++i) {
+            m_Workers.emplace_back(std::make_unique<Worker>());
+        }
+
+        for (std::size_t i = 0; i < m_Settings.workers; ++i) {
+            m_Workers[i]->thread = std::thread{ [this, i] { work(i); } };
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        m_Running = false;
+        m_Signal.fetch_add(1);
+        m_Signal.notify_all();
+        for (auto& worker : m_Workers) {
+            if (worker->thread.joinable()) worker->thread.join();
+        }
+    }
+
+    // ------------------------------------------------
+
+    std::shared_ptr<WorkerPool> WorkerPool::shared() {
+        static std::mutex mutex{};
+        static std::weak_ptr<WorkerPool> instance{};
+
+        std::lock_guard lock{ mutex };
+        if (auto pool = instance.lock()) return pool;
+
+        auto pool = std::make_shared<WorkerPool>();
+        instance = pool;
+        return pool;
+    }
+
+    // ------------------------------------------------
+
+    bool WorkerPool::add(JobGroup& group) {
+        for (std::size_t i = 0; i < MaxGroups; ++i) {
+            JobGroup* expected = nullptr;
+            if (m_Groups[i].compare_exchange_strong(expected, &group)) {
+                std::size_t used = m_UsedSlots.load();
+                while (used < i + 1 && !m_UsedSlots.compare_exchange_weak(used, i + 1));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerPool::remove(JobGroup& group) {
+        for (auto& slot : m_Groups) {
+            JobGroup* expected = &group;
+            if (slot.compare_exchange_strong(expected, nullptr)) break;
+        }
+
+        // Workers that were already scanning may still hold a pointer to
+        // the group, wait for all of them to finish their current scan.
+        for (auto& worker : m_Workers) {
+            const std::uint64_t scan = worker->scan.load();
+            if (scan % 2 == 0) continue; // Not scanning
+            while (worker->scan.load() == scan) KAIXO_CPU_RELAX();
+        }
+    }
+
+    // ------------------------------------------------
+
+    void WorkerPool::submit(JobGroup& group) {
+        if (group.m_Jobs.empty()) return; // Nothing to steal, the waiting thread runs what is left
+
+        m_Signal.fetch_add(1);
+        if (m_Parked.load() != 0) m_Signal.notify_all();
+    }
+
+    void WorkerPool::wait(JobGroup& group) {
+        Job job{};
+        while (group.pop(job)) group.run(job);
+        while (!group.done()) KAIXO_CPU_RELAX();
+    }
+
+    // ------------------------------------------------
+
+    void WorkerPool::work(std::size_t index) {
+        if (m_Settings.affinity != 0) {
+            // Pin to the index'th set bit of the affinity mask (round-robin)
+            std::size_t cores = std::popcount(m_Settings.affinity);
+            std::size_t nth = index % cores;
+            for (std::uint32_t bit = 0; bit < 32; ++bit) {
+                if ((m_Settings.affinity & (1u << bit)) && nth-- == 0) {
+                    juce::Thread::setCurrentThreadAffinityMask(1u << bit);
+                    break;
+                }
+            }
+        }
+
+        Trace::threadName("Worker");
+
+        Worker& self = *m_Workers[index];
+        std::size_t next = index; // Stagger start so workers spread over the groups
+        std::size_t spins = 0;
+        while (m_Running.load(std::memory_order_relaxed)) {
+            if (tryRunOne(self, next)) {
+                spins = 0;
+                continue;
+            }
+
+            if (++spins < m_Settings.spinIterations) {
+                KAIXO_CPU_RELAX();
+                continue;
+            }
+
+            // Park until new work is submitted. The signal is read before checking
+            // for work, so a submit in between makes the wait return immediately.
+            const std::uint32_t signal = m_Signal.load();
+            m_Parked.fetch_add(1);
+            if (!hasWork(self) && m_Running.load()) m_Signal.wait(signal);
+            m_Parked.fetch_sub(1);
+            spins = 0;
+        }
+    }
+
+    bool WorkerPool::tryRunOne(Worker& worker, std::size_t& next) {
+        beginScan(worker);
+        bool ran = false;
+        Job job{};
+        const std::size_t slots = m_UsedSlots.load();
+        for (std::size_t i = 0; i < slots; ++i) {
+            const std::size_t slot = (next + i) % slots;
+            JobGroup* group = m_Groups[slot].load();
+            if (group && group->steal(job)) {
+                group->run(job);
+                next = slot + 1; // Round-robin, continue at the next group
+                ran = true;
+                break;
+            }
+        }
+        endScan(worker);
+        return ran;
+    }
+
+    bool WorkerPool::hasWork(Worker& worker) {
+        beginScan(worker);
+        bool result = false;
+        const std::size_t slots = m_UsedSlots.load();
+        for (std::size_t i = 0; i < slots; ++i) {
+            JobGroup* group = m_Groups[i].load();
+            if (group && !group->m_Jobs.empty()) {
+                result = true;
+                break;
+            }
+        }
+        endScan(worker);
+        return result;
+    }
+
+    // Scan counter is odd while the worker is looking at the groups.
+    void WorkerPool::beginScan(Worker& worker) { worker.scan.store(worker.scan.load(std::memory_order_relaxed) + 1); }
+    void WorkerPool::endScan(Worker& worker) { worker.scan.store(worker.scan.load(std::memory_order_relaxed) + 1); }
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,344 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Utils/Trace.hpp"
+
+// ------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// ------------------------------------------------
+
+namespace Kaixo {
+
+    // ------------------------------------------------
+
+    namespace {
+
+        // ------------------------------------------------
+
+        // Free -> Claimed by a thread on its first event, Released when that
+        // thread exits, and Free again once the drain thread has emptied it.
+        enum class Slot : std::uint8_t { Free, Claimed, Released };
+
+        // Single producer (the owning thread), single consumer (the drain thread).
+        struct ThreadBuffer {
+            std::array<Trace::Event, Trace::Capacity> events{};
+            alignas(64) std::atomic<std::size_t> write = 0;
+            alignas(64) std::atomic<std::size_t> read = 0;
+            std::atomic<std::size_t> dropped = 0;
+            std::atomic<const char*> name = nullptr;
+            std::atomic<Slot> slot = Slot::Free;
+        };
+
+        // ------------------------------------------------
+
+        class Recorder {
+        public:
+
+            // ------------------------------------------------
+
+            ~Recorder() { Trace::stop(); }
+
+            // ------------------------------------------------
+
+            // Buffers are allocated on the first start and never freed, so
+            // threads can keep writing to them while recording is stopped.
+            std::unique_ptr<ThreadBuffer[]> storage{};
+            std::atomic<ThreadBuffer*> buffers = nullptr;
+            std::atomic<std::size_t> rejected = 0; // Threads that found no free buffer
+
+            // ------------------------------------------------
+
+            bool start(const std::filesystem::path& path);
+            void stop();
+
+            // ------------------------------------------------
+
+        private:
+            std::mutex m_Mutex{};
+            std::condition_variable m_Wake{};
+            std::thread m_Thread{};
+            bool m_Running = false;
+
+            std::ofstream m_File{};
+            std::string m_Text{};
+            std::int64_t m_Origin = 0;
+            bool m_First = true;
+            std::array<const char*, Trace::MaxThreads> m_Named{};
+
+            // ------------------------------------------------
+
+            void drain();
+            void discard(std::size_t thread);
+            void append(std::size_t thread, const Trace::Event& event);
+            void separator();
+
+            // ------------------------------------------------
+
+        };
+
+        // ------------------------------------------------
+
+        Recorder recorder{};
+
+        // Hands the buffer back when the thread exits.
+        struct ThreadSlot {
+            ThreadBuffer* buffer = nullptr;
+            bool rejected = false; // No buffers were left for this thread
+
+            ~ThreadSlot() {
+                if (buffer) buffer->slot.store(Slot::Released, std::memory_order_release);
+            }
+        };
+
+        thread_local ThreadSlot current{};
+        thread_local const char* currentName = nullptr;
+
+        // ------------------------------------------------
+
+        std::int64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Trace::clock::now().time_since_epoch()).count();
+        }
+
+        // Claims a free buffer on the first event, without allocating.
+        ThreadBuffer* claim() {
+            if (current.buffer || current.rejected) return current.buffer;
+
+            ThreadBuffer* buffers = recorder.buffers.load(std::memory_order_acquire);
+            if (!buffers) return nullptr;
+
+            for (std::size_t i = 0; i < Trace::MaxThreads; ++i) {
+                Slot expected = Slot::Free;
+                if (buffers[i].slot.compare_exchange_strong(expected, Slot::Claimed, std::memory_order_acq_rel)) {
+                    current.buffer = &buffers[i];
+                    current.buffer->name.store(currentName, std::memory_order_release);
+                    return current.buffer;
+                }
+            }
+
+            current.rejected = true;
+            recorder.rejected.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        void escape(std::string& out, std::string_view text) {
+            for (char c : text) {
+                switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                default: if (static_cast<unsigned char>(c) >= 0x20) out += c; break;
+                }
+            }
+        }
+
+        // ------------------------------------------------
+
+        bool Recorder::start(const std::filesystem::path& path) {
+            std::lock_guard lock{ m_Mutex };
+            if (m_Running) return false;
+
+            m_File.open(path, std::ios::out | std::ios::trunc);
+            if (!m_File) return false;
+
+            if (!storage) {
+                storage = std::make_unique<ThreadBuffer[]>(Trace::MaxThreads);
+                buffers.store(storage.get(), std::memory_order_release);
+            }
+
+            // Discard whatever was written while not recording, and free
+            // the buffers of threads that exited since.
+            m_Named.fill(nullptr);
+            rejected.store(0, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < Trace::MaxThreads; ++i) discard(i);
+
+            m_Origin = now();
+            m_First = true;
+            m_File << "{\"traceEvents\":[\n";
+
+            m_Running = true;
+            m_Thread = std::thread{ [this] {
+                std::unique_lock lock{ m_Mutex };
+                while (m_Running) {
+                    m_Wake.wait_for(lock, std::chrono::milliseconds(10));
+                    drain();
+                }
+            } };
+
+            return true;
+        }
+
+        void Recorder::stop() {
+            {
+                std::lock_guard lock{ m_Mutex };
+                if (!m_Running) return;
+                m_Running = false;
+            }
+
+            m_Wake.notify_all();
+            m_Thread.join();
+
+            drain();
+            m_File << "\n]}\n";
+            m_File.close();
+        }
+
+        // ------------------------------------------------
+
+        void Recorder::drain() {
+            for (std::size_t i = 0; i < Trace::MaxThreads; ++i) {
+                ThreadBuffer& buffer = storage[i];
+
+                // Loaded first, all events of a released buffer are visible
+                const Slot slot = buffer.slot.load(std::memory_order_acquire);
+                if (slot == Slot::Free) continue;
+
+                const char* name = buffer.name.load(std::memory_order_acquire);
+                if (name && name != m_Named[i]) {
+                    m_Named[i] = name;
+                    separator();
+                    m_Text += std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":")", i);
+                    escape(m_Text, name);
+                    m_Text += "\"}}";
+                }
+
+                const std::size_t read = buffer.read.load(std::memory_order_relaxed);
+                const std::size_t write = buffer.write.load(std::memory_order_acquire);
+                for (std::size_t j = read; j < write; ++j) {
+                    append(i, buffer.events[j % Trace::Capacity]);
+                }
+
+                buffer.read.store(write, std::memory_order_release);
+
+                if (const std::size_t dropped = buffer.dropped.exchange(0, std::memory_order_relaxed)) {
+                    separator();
+                    m_Text += std::format(R"({{"name":"Dropped events","ph":"i","s":"t","ts":{:.3f},"pid":1,"tid":{},"args":{{"count":{}}}}})",
+                        (now() - m_Origin) / 1000., i, dropped);
+                }
+
+                if (slot == Slot::Released) {
+                    buffer.name.store(nullptr, std::memory_order_relaxed);
+                    m_Named[i] = nullptr;
+                    buffer.slot.store(Slot::Free, std::memory_order_release);
+                }
+            }
+
+            if (const std::size_t threads = rejected.exchange(0, std::memory_order_relaxed)) {
+                separator();
+                m_Text += std::format(R"({{"name":"Rejected threads","ph":"i","s":"p","ts":{:.3f},"pid":1,"tid":0,"args":{{"count":{}}}}})",
+                    (now() - m_Origin) / 1000., threads);
+            }
+
+            m_File << m_Text;
+            m_File.flush();
+            m_Text.clear();
+        }
+
+        // Only while the drain thread is not running.
+        void Recorder::discard(std::size_t thread) {
+            ThreadBuffer& buffer = storage[thread];
+            buffer.read.store(buffer.write.load(std::memory_order_acquire), std::memory_order_release);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+
+            Slot expected = Slot::Released;
+            if (buffer.slot.compare_exchange_strong(expected, Slot::Free, std::memory_order_acq_rel))
+                buffer.name.store(nullptr, std::memory_order_relaxed);
+        }
+
+        void Recorder::append(std::size_t thread, const Trace::Event& event) {
+            if (event.nanos < m_Origin || !event.name) return; // Written before this recording started
+
+            separator();
+            m_Text += "{\"name\":\"";
+            escape(m_Text, event.name);
+            m_Text += std::format(R"(","ts":{:.3f},"pid":1,"tid":{})", (event.nanos - m_Origin) / 1000., thread);
+
+            switch (event.type) {
+            case Trace::Type::Begin: m_Text += R"(,"ph":"B"})"; break;
+            case Trace::Type::End: m_Text += R"(,"ph":"E"})"; break;
+            case Trace::Type::Counter:
+                m_Text += std::format(R"(,"ph":"C","args":{{"value":{}}}}})", event.value);
+                break;
+            case Trace::Type::Instant:
+                m_Text += R"(,"ph":"i","s":"t")";
+                if (event.payload[0] != '\0') {
+                    m_Text += R"(,"args":{"message":")";
+                    escape(m_Text, event.payload);
+                    m_Text += "\"}";
+                }
+                m_Text += "}";
+                break;
+            }
+        }
+
+        void Recorder::separator() {
+            if (!m_First) m_Text += ",\n";
+            m_First = false;
+        }
+
+        // ------------------------------------------------
+
+    }
+
+    // ------------------------------------------------
+
+    bool Trace::start(const std::filesystem::path& path) {
+        if (!recorder.start(path)) return false;
+        m_Enabled.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void Trace::stop() {
+        m_Enabled.store(false, std::memory_order_release);
+        recorder.stop();
+    }
+
+    // ------------------------------------------------
+
+    void Trace::threadName(const char* name) {
+        if (currentName == name) return;
+        currentName = name;
+        if (current.buffer) current.buffer->name.store(name, std::memory_order_release);
+    }
+
+    // ------------------------------------------------
+
+    void Trace::record(Type type, const char* name, double value, std::string_view payload) {
+        ThreadBuffer* buffer = claim();
+        if (!buffer) return;
+
+        const std::size_t write = buffer->write.load(std::memory_order_relaxed);
+        if (write - buffer->read.load(std::memory_order_acquire) >= Capacity) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Event& event = buffer->events[write % Capacity];
+        event.name = name;
+        event.nanos = now();
+        event.value = value;
+        event.type = type;
+
+        const std::size_t size = std::min(payload.size(), PayloadSize - 1);
+        std::memcpy(event.payload, payload.data(), size);
+        event.payload[size] = '\0';
+
+        buffer->write.store(write + 1, std::memory_order_release);
+    }
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,172 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Utils/Containers.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+    template<std::size_t Size>
+    std::vector<std::size_t> contents(const IndexList<Size>& list) {
+        std::vector<std::size_t> result;
+        list.foreach([&](std::size_t i) { result.push_back(i); });
+        return result;
+    }
+
+    template<class Type, std::size_t Size>
+    std::vector<Type> contents(StateVector<Type, Size>& vector) {
+        std::vector<Type> result;
+        vector.foreach([&](Type i) { result.push_back(i); });
+        return result;
+    }
+
+    // ------------------------------------------------
+
+    class IndexSetTests : public ::testing::TestWithParam<std::size_t> {};
+
+    TEST_P(IndexSetTests, SingleIndex) {
+        constexpr std::size_t Size = 130; // 3 words, the last one partially used
+        const std::size_t index = GetParam();
+
+        IndexSet<Size> set;
+        set.set(index);
+        ASSERT_TRUE(set.test(index));
+        ASSERT_EQ(set.first(), index);
+        ASSERT_EQ(set.first(index), index);
+        ASSERT_EQ(set.first(index + 1), IndexSet<Size>::npos);
+        ASSERT_EQ(set.last(), index);
+
+        set.unset(index);
+        ASSERT_FALSE(set.test(index));
+        ASSERT_EQ(set.first(), IndexSet<Size>::npos);
+        ASSERT_EQ(set.last(), IndexSet<Size>::npos);
+    }
+
+    INSTANTIATE_TEST_CASE_P(IndexSetTests, IndexSetTests, ::testing::Values(0, 1, 63, 64, 65, 127, 128, 129));
+
+    TEST(IndexSetTests, WordBoundaries) {
+        constexpr std::size_t Size = 130;
+        IndexSet<Size> set;
+        set.set(63);
+        set.set(64);
+        set.set(Size - 1);
+
+        ASSERT_EQ(set.first(), 63);
+        ASSERT_EQ(set.first(63), 63);
+        ASSERT_EQ(set.first(64), 64);
+        ASSERT_EQ(set.first(65), Size - 1);
+        ASSERT_EQ(set.first(Size - 1), Size - 1);
+        ASSERT_EQ(set.first(Size), IndexSet<Size>::npos);
+        ASSERT_EQ(set.last(), Size - 1);
+
+        set.unset(Size - 1);
+        ASSERT_EQ(set.last(), 64);
+        set.unset(64);
+        ASSERT_EQ(set.last(), 63);
+        ASSERT_EQ(set.first(64), IndexSet<Size>::npos);
+    }
+
+    TEST(IndexSetTests, FillAndClear) {
+        IndexSet<128> set;
+        set.fill();
+        ASSERT_EQ(set.first(), 0);
+        ASSERT_EQ(set.first(100), 100);
+        ASSERT_EQ(set.last(), 127);
+
+        set.clear();
+        ASSERT_EQ(set.first(), IndexSet<128>::npos);
+        ASSERT_EQ(set.last(), IndexSet<128>::npos);
+    }
+
+    // ------------------------------------------------
+
+    TEST(IndexListTests, KeepsInsertionOrder) {
+        IndexList<8> list;
+        ASSERT_TRUE(list.empty());
+        ASSERT_EQ(list.front(), IndexList<8>::npos);
+
+        list.push_back(3);
+        list.push_back(0);
+        list.push_back(7);
+        ASSERT_FALSE(list.empty());
+        ASSERT_EQ(list.front(), 3);
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 3, 0, 7 }));
+    }
+
+    TEST(IndexListTests, PushBackOfContainedIndexMovesIt) {
+        IndexList<8> list;
+        list.push_back(1);
+        list.push_back(2);
+        list.push_back(3);
+
+        list.push_back(1); // Front to back
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 2, 3, 1 }));
+        list.push_back(3); // Middle to back
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 2, 1, 3 }));
+        list.push_back(3); // Already at the back
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 2, 1, 3 }));
+    }
+
+    TEST(IndexListTests, Remove) {
+        IndexList<8> list;
+        for (std::size_t i : { 4, 5, 6, 7 }) list.push_back(i);
+
+        list.remove(5); // Middle
+        ASSERT_FALSE(list.contains(5));
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 4, 6, 7 }));
+        list.remove(4); // Front
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 6, 7 }));
+        list.remove(7); // Back
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 6 }));
+        list.remove(7); // Not in the list
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 6 }));
+
+        list.push_back(5); // Removed indices can be added again
+        ASSERT_EQ(contents(list), (std::vector<std::size_t>{ 6, 5 }));
+    }
+
+    TEST(IndexListTests, PopFront) {
+        IndexList<8> list;
+        for (std::size_t i : { 2, 0, 1 }) list.push_back(i);
+
+        ASSERT_EQ(list.pop_front(), 2);
+        ASSERT_EQ(list.pop_front(), 0);
+        ASSERT_TRUE(list.contains(1));
+        ASSERT_EQ(list.pop_front(), 1);
+        ASSERT_FALSE(list.contains(1));
+        ASSERT_TRUE(list.empty());
+        ASSERT_EQ(list.pop_front(), IndexList<8>::npos);
+    }
+
+    // ------------------------------------------------
+
+    TEST(StateVectorTests, UnsetIfKeepsOrder) {
+        StateVector<std::size_t, 16> vector;
+        for (std::size_t i : { 9, 2, 7, 4, 11, 0 }) vector.set(i);
+
+        vector.unset_if([](std::size_t i) { return i % 2 == 1; });
+        ASSERT_EQ(contents(vector), (std::vector<std::size_t>{ 2, 4, 0 }));
+        for (std::size_t i : { 9, 7, 11 }) ASSERT_FALSE(vector.test(i));
+        for (std::size_t i : { 2, 4, 0 }) ASSERT_TRUE(vector.test(i));
+
+        vector.set(7); // Unset indices can be set again, at the back
+        ASSERT_EQ(contents(vector), (std::vector<std::size_t>{ 2, 4, 0, 7 }));
+
+        vector.unset_if([](std::size_t) { return false; });
+        ASSERT_EQ(contents(vector), (std::vector<std::size_t>{ 2, 4, 0, 7 }));
+
+        vector.unset_if([](std::size_t) { return true; });
+        ASSERT_TRUE(contents(vector).empty());
+        for (std::size_t i = 0; i < 16; ++i) ASSERT_FALSE(vector.test(i));
+    }
+
+    // ------------------------------------------------
+
+}
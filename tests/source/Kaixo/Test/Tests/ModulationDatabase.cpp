@@ -0,0 +1,104 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/ModulationDatabase.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+#ifdef KAIXO_INTERNAL_MODULATION
+
+    // ------------------------------------------------
+
+    using Processing::ModulationDatabase;
+
+    // First parameter that ends up in the compiled routing when modulated.
+    std::optional<ParamID> modulatableParameter() {
+        for (ParamID id = 0; id < ModulationDatabase::Parameters; ++id) {
+            const ParameterSettings& settings = parameter(id);
+            if (settings.doModulation() && settings.doSmoothing()) return id;
+        }
+        return std::nullopt;
+    }
+
+    // ------------------------------------------------
+
+    TEST(ModulationDatabaseTests, EditReachesMatrixAfterUpdate) {
+        auto id = modulatableParameter();
+        if (!id || ModulationDatabase::Sources == 0) GTEST_SKIP() << "No modulatable parameters";
+
+        ModulationDatabase database;
+        database.init();
+        ASSERT_TRUE(database.update());
+        const std::uint64_t version = database.matrix().version;
+        ASSERT_FALSE(database.matrix().modulated(*id));
+
+        database.set(*id, 0, 0.5f);
+        ASSERT_EQ(database.matrix().version, version); // Not visible before the audio thread updates
+        ASSERT_TRUE(database.update());
+        ASSERT_NE(database.matrix().version, version);
+        ASSERT_TRUE(database.matrix().modulated(*id));
+        ASSERT_EQ(database.matrix().entries(), 1);
+        ASSERT_FLOAT_EQ(database.matrix().amounts[0], 0.5f);
+
+        database.set(*id, 0, 0);
+        ASSERT_TRUE(database.update());
+        ASSERT_FALSE(database.matrix().modulated(*id));
+        ASSERT_FALSE(database.update()); // Nothing new published
+    }
+
+    TEST(ModulationDatabaseTests, BatchEditIsPublishedAtOnce) {
+        auto id = modulatableParameter();
+        if (!id || ModulationDatabase::Sources < 2) GTEST_SKIP() << "Not enough sources";
+
+        ModulationDatabase database;
+        database.init();
+        database.update();
+
+        const ModulationDatabase::Route routes[]{
+            { .param = *id, .source = 0, .amount = 0.25f },
+            { .param = *id, .source = 1, .amount = 0.75f },
+        };
+
+        database.set(routes);
+        ASSERT_TRUE(database.update());
+        ASSERT_EQ(database.matrix().entries(), 2);
+    }
+
+    TEST(ModulationDatabaseTests, MatrixQueriesMatchRouting) {
+        auto id = modulatableParameter();
+        if (!id || ModulationDatabase::Sources < 2) GTEST_SKIP() << "Not enough sources";
+
+        ModulationDatabase database;
+        database.init();
+        database.set(*id, 0, 0.25f);
+        database.set(*id, 1, 0.75f);
+        database.update();
+
+        const auto& matrix = database.matrix();
+        ASSERT_EQ(matrix.nofLinkedSource(*id), database.nofLinkedSource(*id));
+        ASSERT_EQ(matrix.nofLinkedSource(*id + 1), database.nofLinkedSource(*id + 1));
+
+        std::size_t count = 0;
+        matrix.foreach(*id, [&](ModulationSourceID source, float amount) {
+            ASSERT_FLOAT_EQ(amount, database.get(*id, source));
+            ++count;
+        });
+
+        ASSERT_EQ(count, 2);
+    }
+
+    // ------------------------------------------------
+
+#endif
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,102 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Oversampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+    using Processing::Oversampler;
+    using Processing::Stereo;
+
+    // ------------------------------------------------
+
+    // Round trip of a unit impulse at sample 0, in blocks like a host would.
+    std::vector<Stereo> impulseResponse(Oversampler& oversampler, std::size_t samples) {
+        constexpr std::size_t BlockSize = 256;
+        std::vector<Stereo> result(samples);
+        result[0] = { 1, 1 };
+
+        for (std::size_t i = 0; i < samples; i += BlockSize) {
+            const std::span<Stereo> block = std::span{ result }.subspan(i, Math::min(BlockSize, samples - i));
+            oversampler.upsample(block);
+            oversampler.downsample(block);
+        }
+
+        return result;
+    }
+
+    // ------------------------------------------------
+
+    struct Setting {
+        Oversampler::Phase phase;
+        std::size_t factor;
+    };
+
+    class OversamplerLatencyTests : public ::testing::TestWithParam<Setting> {};
+
+    // The centre of mass of the impulse response is the group delay at DC, which
+    // is what the latency reports, for the symmetric and the minimum phase filters.
+    TEST_P(OversamplerLatencyTests, ImpulseDelayMatchesLatency) {
+        auto& [phase, factor] = GetParam();
+
+        Oversampler oversampler;
+        oversampler.factor(factor);
+        oversampler.phase(phase);
+        oversampler.prepare(256);
+        oversampler.reset();
+        ASSERT_EQ(oversampler.factor(), factor);
+
+        const auto response = impulseResponse(oversampler, 4096);
+
+        double sum = 0;
+        double moment = 0;
+        for (std::size_t i = 0; i < response.size(); ++i) {
+            sum += response[i].l;
+            moment += i * static_cast<double>(response[i].l);
+        }
+
+        ASSERT_NEAR(sum, 1, 1e-3); // Unity gain at DC
+        ASSERT_NEAR(moment / sum, oversampler.latency(), 0.01);
+    }
+
+    // A linear phase response is symmetric, so it peaks at the latency.
+    TEST(OversamplerTests, LinearPhasePeaksAtLatency) {
+        for (std::size_t factor : { 2, 4, 8, 16 }) {
+            Oversampler oversampler;
+            oversampler.factor(factor);
+            oversampler.phase(Oversampler::Phase::Linear);
+            oversampler.prepare(256);
+            oversampler.reset();
+
+            const auto response = impulseResponse(oversampler, 1024);
+            const auto peak = std::ranges::max_element(response, {}, [](const Stereo& sample) { return sample.l; });
+            ASSERT_NEAR(static_cast<double>(peak - response.begin()), oversampler.latency(), 0.5) << "factor " << factor;
+        }
+    }
+
+    INSTANTIATE_TEST_CASE_P(OversamplerTests, OversamplerLatencyTests, ::testing::Values(
+        Setting{ Oversampler::Phase::Linear, 1 },
+        Setting{ Oversampler::Phase::Linear, 2 },
+        Setting{ Oversampler::Phase::Linear, 4 },
+        Setting{ Oversampler::Phase::Linear, 8 },
+        Setting{ Oversampler::Phase::Linear, 16 },
+        Setting{ Oversampler::Phase::Minimum, 1 },
+        Setting{ Oversampler::Phase::Minimum, 2 },
+        Setting{ Oversampler::Phase::Minimum, 4 },
+        Setting{ Oversampler::Phase::Minimum, 8 },
+        Setting{ Oversampler::Phase::Minimum, 16 }
+    ));
+
+    // ------------------------------------------------
+
+}
+
+// ------------------------------------------------
@@ -0,0 +1,213 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/Resampler.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+    using Processing::Resampler;
+    using Processing::Stereo;
+
+    // ------------------------------------------------
+
+    constexpr double pi = std::numbers::pi;
+
+    std::vector<Stereo> sine(double frequency, double sampleRate, std::size_t samples) {
+        std::vector<Stereo> result(samples);
+        for (std::size_t i = 0; i < samples; ++i) {
+            const float value = static_cast<float>(std::sin(2 * pi * frequency * i / sampleRate));
+            result[i] = { value, value };
+        }
+        return result;
+    }
+
+    std::vector<Stereo> resample(double in, double out, const std::vector<Stereo>& input) {
+        Resampler resampler;
+        resampler.samplerate.in = in;
+        resampler.samplerate.out = out;
+
+        std::vector<Stereo> output(static_cast<std::size_t>(input.size() * out / in));
+        auto result = resampler.process(input, output);
+        output.resize(result.produced);
+        return output;
+    }
+
+    // Output samples until the start of the input has passed through the kernel.
+    std::size_t settle(double in, double out) {
+        return static_cast<std::size_t>(2 * Resampler::MaxTaps * Math::max(out / in, 1.));
+    }
+
+    // Complex amplitude of a frequency in the output, relative to the input sine. Output
+    // sample j sits at input sample j * in / out, minus the latency of the resampler.
+    std::complex<double> response(double in, double out, double frequency, const std::vector<Stereo>& output) {
+        const std::size_t skip = settle(in, out);
+        std::complex<double> measured{};
+        std::complex<double> expected{};
+        for (std::size_t j = skip; j + skip < output.size(); ++j) {
+            const double time = j * in / out - Resampler::latency();
+            const std::complex<double> rotation = std::polar(1., -2 * pi * frequency * time / in);
+            measured += static_cast<double>(output[j].l) * rotation;
+            expected += std::sin(2 * pi * frequency * time / in) * rotation;
+        }
+        return measured / expected;
+    }
+
+    // ------------------------------------------------
+
+    struct Conversion {
+        double in;
+        double out;
+        double frequency;
+        double minimum; // Signal to noise ratio in dB
+    };
+
+    class ResamplerSineTests : public ::testing::TestWithParam<Conversion> {};
+
+    TEST_P(ResamplerSineTests, SignalToNoise) {
+        auto& [in, out, frequency, minimum] = GetParam();
+        
+        const auto output = resample(in, out, sine(frequency, in, 40000));
+        const std::size_t skip = settle(in, out);
+
+        double signal = 0;
+        double noise = 0;
+        for (std::size_t j = skip; j + skip < output.size(); ++j) {
+            const double time = j * in / out - Resampler::latency();
+            const double expected = std::sin(2 * pi * frequency * time / in);
+            signal += expected * expected;
+            noise += (output[j].l - expected) * (output[j].l - expected);
+        }
+
+        const double snr = 10 * std::log10(signal / noise);
+        ASSERT_GT(snr, minimum);
+    }
+
+    INSTANTIATE_TEST_CASE_P(ResamplerTests, ResamplerSineTests, ::testing::Values(
+        Conversion{ 44100, 48000, 1000, 80 },
+        Conversion{ 44100, 48000, 15000, 80 },
+        Conversion{ 48000, 44100, 1000, 80 },
+        Conversion{ 48000, 44100, 15000, 80 },
+        Conversion{ 48000, 96000, 5000, 80 },
+        Conversion{ 96000, 48000, 5000, 80 },
+        Conversion{ 48000, 192000, 5000, 80 },
+        Conversion{ 192000, 48000, 5000, 80 }
+    ));
+
+    // ------------------------------------------------
+
+    struct Stopband {
+        double in;
+        double out;
+        double frequency; // Above the output Nyquist
+        double maximum;   // Level of everything that comes through, in dB
+    };
+
+    class ResamplerStopbandTests : public ::testing::TestWithParam<Stopband> {};
+
+    TEST_P(ResamplerStopbandTests, Suppression) {
+        auto& [in, out, frequency, maximum] = GetParam();
+
+        const auto output = resample(in, out, sine(frequency, in, 40000));
+        
+        double energy = 0;
+        std::size_t samples = 0;
+        for (std::size_t j = settle(in, out); j < output.size(); ++j, ++samples) {
+            energy += output[j].l * output[j].l;
+        }
+
+        // Relative to the energy of a full scale sine
+        const double level = 10 * std::log10(2 * energy / samples);
+        ASSERT_LT(level, maximum);
+    }
+
+    INSTANTIATE_TEST_CASE_P(ResamplerTests, ResamplerStopbandTests, ::testing::Values(
+        Stopband{ 48000, 44100, 23000, -50 },
+        Stopband{ 96000, 48000, 30000, -50 },
+        Stopband{ 192000, 48000, 40000, -50 },
+        Stopband{ 192000, 48000, 60000, -50 }
+    ));
+
+    // ------------------------------------------------
+
+    TEST(ResamplerTests, FullBandTransitionIsCentredOnNyquist) {
+        // Without downsampling the cutoff is at the input Nyquist, the transition of the 
+        // 32 tap kernel is about 0.08 of the sample rate on both sides of it. So at 48 kHz 
+        // the passband is flat up to 21 kHz, and content near Nyquist is attenuated.
+        auto gain = [](double frequency) {
+            const auto output = resample(48000, 48480, sine(frequency, 48000, 20000));
+            return 20 * std::log10(std::abs(response(48000, 48480, frequency, output)));
+        };
+
+        for (double frequency : { 1000., 10000., 18000., 21000. }) {
+            ASSERT_NEAR(gain(frequency), 0, 0.1);
+        }
+
+        ASSERT_LT(gain(22000), -0.3);
+        ASSERT_LT(gain(23000), -1.5);
+        ASSERT_GT(gain(23000), -3.5);
+    }
+
+    // ------------------------------------------------
+
+    TEST(ResamplerTests, SplitCallsMatchSingleCall) {
+        std::vector<Stereo> input(10000);
+        std::mt19937 random{ 1 };
+        std::uniform_real_distribution<float> noise{ -1, 1 };
+        for (auto& sample : input) sample = { noise(random), noise(random) };
+
+        for (auto [in, out] : { std::pair{ 44100., 48000. }, { 48000., 44100. }, { 192000., 48000. } }) {
+            Resampler single;
+            single.samplerate.in = in;
+            single.samplerate.out = out;
+            std::vector<Stereo> expected(input.size() * 2);
+            auto total = single.process(input, expected);
+
+            Resampler split;
+            split.samplerate.in = in;
+            split.samplerate.out = out;
+            std::vector<Stereo> output(expected.size());
+            Resampler::Result result;
+            while (result.consumed < input.size()) {
+                const std::size_t inputs = Math::min<std::size_t>(random() % 300, input.size() - result.consumed);
+                const std::size_t outputs = Math::min<std::size_t>(random() % 300, output.size() - result.produced);
+                auto part = split.process(std::span{ input }.subspan(result.consumed, inputs), std::span{ output }.subspan(result.produced, outputs));
+                ASSERT_LE(part.consumed, inputs);
+                ASSERT_LE(part.produced, outputs);
+                result.consumed += part.consumed;
+                result.produced += part.produced;
+            }
+
+            ASSERT_EQ(result.consumed, total.consumed);
+            ASSERT_EQ(result.produced, total.produced);
+            for (std::size_t i = 0; i < total.produced; ++i) {
+                ASSERT_EQ(output[i].l, expected[i].l);
+                ASSERT_EQ(output[i].r, expected[i].r);
+            }
+        }
+    }
+
+    TEST(ResamplerTests, OutputAlignsWithLatency) {
+        constexpr std::size_t impulse = 1000;
+        for (auto [in, out] : { std::pair{ 48000., 48000. }, { 48000., 96000. }, { 96000., 48000. } }) {
+            std::vector<Stereo> input(4000);
+            input[impulse] = { 1, 1 };
+            const auto output = resample(in, out, input);
+
+            // The peak is at the output sample that lines up with the delayed impulse
+            const auto peak = std::ranges::max_element(output, {}, [](Stereo s) { return s.l; });
+            const double expected = (impulse + Resampler::latency()) * out / in;
+            ASSERT_EQ(static_cast<double>(peak - output.begin()), expected);
+        }
+    }
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,367 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/VoiceBank.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    struct TestVoice : Voice {
+        float loudness = 1;
+        std::size_t triggers = 0;
+
+        void trigger() override { ++triggers; }
+        void release() override {}
+        float level() const override { return loudness; }
+    };
+
+    // Full bank of 4 voices, triggered with notes 60, 61, 62 and 63.
+    class VoiceStealTests : public ::testing::Test {
+    public:
+        using Bank = VoiceBank<TestVoice, 4>;
+        using Steal = Bank::Steal;
+
+        Bank bank;
+
+        void fill(std::initializer_list<Note> notes = { 60, 61, 62, 63 }) {
+            for (Note note : notes) bank.noteOn(note, 1, 0);
+        }
+
+        // Voice that plays a note, asserts there is exactly one.
+        std::size_t voiceOf(Note note) {
+            std::size_t result = npos;
+            for (std::size_t i = 0; i < 4; ++i) {
+                if (bank[i].note != note) continue;
+                EXPECT_EQ(result, npos) << "note " << note << " is on multiple voices";
+                result = i;
+            }
+            EXPECT_NE(result, npos) << "note " << note << " is not on a voice";
+            return result;
+        }
+
+        bool playing(Note note) {
+            for (auto& voice : bank) if (voice.note == note) return true;
+            return false;
+        }
+    };
+
+    // ------------------------------------------------
+
+    TEST_F(VoiceStealTests, OldestStealsFirstPressed) {
+        bank.steal(Steal::Oldest);
+        fill();
+        const std::size_t oldest = voiceOf(60);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), oldest);
+        ASSERT_TRUE(bank[oldest].pressed);
+        ASSERT_TRUE(bank[oldest].stolen);
+        ASSERT_TRUE(bank[oldest].legato); // Stealing a pressed voice glides
+        ASSERT_FALSE(playing(60));
+    }
+
+    TEST_F(VoiceStealTests, OldestStealsFirstReleased) {
+        bank.steal(Steal::Oldest);
+        fill();
+        bank.noteOff(62, 1, 0);
+        bank.noteOff(61, 1, 0);
+        const std::size_t released = voiceOf(62);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), released); // Released voices go before older pressed ones
+        ASSERT_TRUE(bank[released].stolen);
+        ASSERT_FALSE(bank[released].legato);
+        ASSERT_TRUE(playing(60));
+        ASSERT_TRUE(playing(61));
+    }
+
+    TEST_F(VoiceStealTests, QuietestStealsQuietestPressed) {
+        bank.steal(Steal::Quietest);
+        fill();
+        bank[voiceOf(62)].loudness = 0.1f;
+        bank[voiceOf(61)].loudness = 0.5f;
+        const std::size_t quietest = voiceOf(62);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), quietest);
+    }
+
+    TEST_F(VoiceStealTests, QuietestStealsQuietestReleased) {
+        bank.steal(Steal::Quietest);
+        fill();
+        bank[voiceOf(60)].loudness = 0.5f;
+        bank[voiceOf(61)].loudness = 0.2f;
+        bank[voiceOf(63)].loudness = 0.01f; // Quieter, but still pressed
+        bank.noteOff(60, 1, 0);
+        bank.noteOff(61, 1, 0);
+        const std::size_t quietest = voiceOf(61);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), quietest);
+    }
+
+    TEST_F(VoiceStealTests, LowestNoteStealsLowestPressed) {
+        bank.steal(Steal::LowestNote);
+        fill({ 62, 60, 63, 61 });
+        const std::size_t lowest = voiceOf(60);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), lowest);
+
+        // The stolen note is still held, and gets the voice back once it is free
+        bank.noteOff(64, 1, 0);
+        ASSERT_EQ(voiceOf(60), lowest);
+        ASSERT_TRUE(bank[lowest].pressed);
+    }
+
+    TEST_F(VoiceStealTests, HighestNoteStealsHighestPressed) {
+        bank.steal(Steal::HighestNote);
+        fill({ 62, 60, 63, 61 });
+        const std::size_t highest = voiceOf(63);
+
+        bank.noteOn(50, 1, 0);
+        ASSERT_EQ(voiceOf(50), highest);
+    }
+
+    TEST_F(VoiceStealTests, NotePriorityStealsReleasedFirst) {
+        bank.steal(Steal::HighestNote);
+        fill();
+        bank.noteOff(60, 1, 0); // Lowest note, but releasing
+        const std::size_t released = voiceOf(60);
+
+        bank.noteOn(64, 1, 0);
+        ASSERT_EQ(voiceOf(64), released);
+        ASSERT_TRUE(playing(63));
+    }
+
+    TEST_F(VoiceStealTests, SameNoteReuse) {
+        bank.steal(Steal::Oldest);
+        fill();
+        bank.noteOff(60, 1, 0);
+        bank.noteOff(61, 1, 0);
+        const std::size_t previous = voiceOf(61);
+
+        bank.sameNoteReuse(true);
+        bank.noteOn(61, 1, 0);
+        ASSERT_EQ(voiceOf(61), previous); // Not the voice of 60, which was released first
+        ASSERT_TRUE(bank[previous].pressed);
+        ASSERT_TRUE(playing(60));
+    }
+
+    TEST_F(VoiceStealTests, SameNoteReuseDisabled) {
+        bank.steal(Steal::Oldest);
+        fill();
+        bank.noteOff(60, 1, 0);
+        bank.noteOff(61, 1, 0);
+        const std::size_t oldest = voiceOf(60);
+
+        bank.sameNoteReuse(false);
+        bank.noteOn(61, 1, 0);
+        ASSERT_EQ(bank[oldest].note, 61);
+    }
+
+    // ------------------------------------------------
+
+    struct BatchedTestVoice;
+
+    // Keeps the release of its voices, like a BatchEnvelope would.
+    struct TestBatch {
+        constexpr static std::size_t Lanes = 2;
+
+        std::array<std::size_t, Lanes> releasing{}; // Blocks left in the release
+        std::array<bool, Lanes> gate{};
+
+        bool active(std::size_t lane) const { return gate[lane] || releasing[lane] != 0; }
+
+        void process(std::array<BatchedTestVoice*, Lanes>&) {
+            for (auto& blocks : releasing) if (blocks != 0) --blocks;
+        }
+    };
+
+    struct BatchedTestVoice : BatchedVoice<TestBatch> {
+        void trigger() override { if (batch) batch->gate[lane] = true; }
+        void release() override {
+            if (!batch) return;
+            batch->gate[lane] = false;
+            batch->releasing[lane] = 3;
+        }
+    };
+
+    TEST(BatchedVoiceTests, NotPrunedDuringRelease) {
+        VoiceBank<BatchedTestVoice, 4> bank;
+        bank.noteOn(60, 1, 0);
+
+        std::size_t voice = 0;
+        while (bank[voice].note != 60) ++voice;
+        ASSERT_NE(bank[voice].batch, nullptr);
+        auto& batch = *bank[voice].batch;
+        const std::size_t lane = bank[voice].lane;
+
+        bank.noteOff(60, 1, 0);
+        for (std::size_t block = 0; block < 3; ++block) {
+            ASSERT_TRUE(bank[voice].active()) << "block " << block;
+            bank.process();
+        }
+
+        // Only finished once the batch has run the complete release
+        ASSERT_EQ(batch.releasing[lane], 0);
+        ASSERT_FALSE(bank[voice].active());
+    }
+
+    TEST(BatchedVoiceTests, UnbatchedVoicesHaveNoBatch) {
+        VoiceBank<BatchedTestVoice, 4> bank;
+        bank.batching(false);
+        for (auto& voice : bank) ASSERT_EQ(voice.batch, nullptr);
+
+        bank.batching(true);
+        for (auto& voice : bank) ASSERT_NE(voice.batch, nullptr);
+    }
+
+    // ------------------------------------------------
+
+    class NoteIDMapTests : public ::testing::Test {
+    public:
+        using Map = NoteIDMap<4>; // 8 slots
+        constexpr static std::size_t Last = Map::Slots - 1;
+
+        Map map;
+
+        // The n'th id whose probe sequence starts at the slot.
+        static NoteID idAt(std::size_t slot, std::size_t n = 0) {
+            for (NoteID id = 1;; ++id) {
+                if (id != NoNoteID && Map::home(id) == slot && n-- == 0) return id;
+            }
+        }
+
+        std::size_t slotOf(NoteID id) const {
+            for (std::size_t i = 0; i < Map::Slots; ++i) if (map.slots[i].id == id) return i;
+            return npos;
+        }
+    };
+
+    // ------------------------------------------------
+
+    TEST_F(NoteIDMapTests, InsertFindErase) {
+        ASSERT_EQ(map.find(idAt(0)), Map::NoVoice);
+        ASSERT_EQ(map.find(NoNoteID), Map::NoVoice);
+
+        map.insert(idAt(0), 2);
+        map.insert(idAt(3), 1);
+        ASSERT_EQ(map.find(idAt(0)), 2);
+        ASSERT_EQ(map.find(idAt(3)), 1);
+
+        map.insert(idAt(0), 3); // Same id again moves it to another voice
+        ASSERT_EQ(map.find(idAt(0)), 3);
+
+        map.erase(idAt(0), 2); // Belongs to another voice now, stays
+        ASSERT_EQ(map.find(idAt(0)), 3);
+        map.erase(idAt(0), 3);
+        ASSERT_EQ(map.find(idAt(0)), Map::NoVoice);
+        ASSERT_EQ(map.find(idAt(3)), 1);
+
+        map.insert(NoNoteID, 0); // Ignored
+        ASSERT_EQ(map.find(NoNoteID), Map::NoVoice);
+    }
+
+    TEST_F(NoteIDMapTests, CollisionsWrapPastTheEnd) {
+        const NoteID a = idAt(Last, 0);
+        const NoteID b = idAt(Last, 1);
+        const NoteID c = idAt(Last, 2);
+        const NoteID d = idAt(0);
+
+        map.insert(a, 0);
+        map.insert(b, 1);
+        map.insert(c, 2);
+        map.insert(d, 3);
+        ASSERT_EQ(slotOf(a), Last);
+        ASSERT_EQ(slotOf(b), 0);
+        ASSERT_EQ(slotOf(c), 1);
+        ASSERT_EQ(slotOf(d), 2);
+
+        for (auto [id, voice] : { std::pair{ a, 0 }, { b, 1 }, { c, 2 }, { d, 3 } }) {
+            ASSERT_EQ(map.find(id), voice);
+        }
+
+        // Every entry shifts back one slot, across the end of the table
+        map.erase(a, 0);
+        ASSERT_EQ(map.find(a), Map::NoVoice);
+        ASSERT_EQ(slotOf(b), Last);
+        ASSERT_EQ(slotOf(c), 0);
+        ASSERT_EQ(slotOf(d), 1);
+        ASSERT_EQ(map.find(b), 1);
+        ASSERT_EQ(map.find(c), 2);
+        ASSERT_EQ(map.find(d), 3);
+
+        // d is at its home slot now, so it does not move into the gap before it
+        map.erase(c, 2);
+        ASSERT_EQ(slotOf(b), Last);
+        ASSERT_EQ(slotOf(d), 0);
+        ASSERT_EQ(map.find(b), 1);
+        ASSERT_EQ(map.find(d), 3);
+
+        map.erase(b, 1);
+        ASSERT_EQ(slotOf(d), 0);
+        ASSERT_EQ(map.find(d), 3);
+
+        map.erase(d, 3);
+        for (auto& slot : map.slots) ASSERT_EQ(slot.id, NoNoteID);
+    }
+
+    TEST_F(NoteIDMapTests, WrappedEntryShiftsBackBeforeTheEnd) {
+        // b wrapped past the end of the table, erasing e moves it back to the last slot
+        const NoteID a = idAt(Last - 1, 0);
+        const NoteID b = idAt(Last - 1, 1);
+        const NoteID e = idAt(Last);
+
+        map.insert(a, 0); // Last - 1
+        map.insert(e, 1); // Last
+        map.insert(b, 2); // Wraps to 0
+
+        map.erase(e, 1);
+        ASSERT_EQ(slotOf(b), Last);
+        ASSERT_EQ(map.find(a), 0);
+        ASSERT_EQ(map.find(b), 2);
+        ASSERT_EQ(map.find(e), Map::NoVoice);
+    }
+
+    TEST_F(NoteIDMapTests, MatchesReference) {
+        // Ids that all start near the end of the table, so most probes wrap
+        std::vector<NoteID> ids;
+        for (std::size_t n = 0; n < 3; ++n) {
+            for (std::size_t slot : { Last - 1, Last, std::size_t{ 0 } }) ids.push_back(idAt(slot, n));
+        }
+
+        std::map<NoteID, std::size_t> reference;
+        std::mt19937 random{ 1 };
+        for (std::size_t step = 0; step < 20000; ++step) {
+            const NoteID id = ids[random() % ids.size()];
+            const std::size_t voice = random() % 4;
+            if (random() % 2 && (reference.contains(id) || reference.size() < 4)) {
+                map.insert(id, voice);
+                reference[id] = voice;
+            } else {
+                map.erase(id, voice);
+                if (reference.contains(id) && reference[id] == voice) reference.erase(id);
+            }
+
+            for (NoteID other : ids) {
+                const auto it = reference.find(other);
+                ASSERT_EQ(map.find(other), it == reference.end() ? Map::NoVoice : it->second) << "step " << step;
+            }
+        }
+    }
+
+    // ------------------------------------------------
+
+}
@@ -0,0 +1,162 @@
+
+// ------------------------------------------------
+
+#include "Kaixo/Test/Test.hpp"
+
+// ------------------------------------------------
+
+#include "Kaixo/Core/Processing/WorkerPool.hpp"
+
+// ------------------------------------------------
+
+namespace Kaixo::Test {
+
+    // ------------------------------------------------
+
+    using namespace Processing;
+
+    // ------------------------------------------------
+
+    TEST(WorkStealingQueueTests, SingleThreaded) {
+        WorkStealingQueue<int, 4> queue;
+        int value = 0;
+
+        ASSERT_TRUE(queue.empty());
+        ASSERT_FALSE(queue.pop(value));
+        ASSERT_FALSE(queue.steal(value));
+
+        for (int i = 0; i < 4; ++i) ASSERT_TRUE(queue.push(i));
+        ASSERT_FALSE(queue.push(4)); // Full
+
+        ASSERT_TRUE(queue.pop(value)); // Owner takes the newest
+        ASSERT_EQ(value, 3);
+        ASSERT_TRUE(queue.steal(value)); // Thieves take the oldest
+        ASSERT_EQ(value, 0);
+        ASSERT_TRUE(queue.push(5)); // Wraps around
+        ASSERT_TRUE(queue.steal(value));
+        ASSERT_EQ(value, 1);
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(value, 5);
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(value, 2);
+        ASSERT_TRUE(queue.empty());
+    }
+
+    // Owner pushes and pops while thieves steal, every value has to be taken exactly once.
+    TEST(WorkStealingQueueTests, EveryValueIsTakenOnce) {
+        constexpr std::size_t Values = 200000;
+        constexpr std::size_t Thieves = 3;
+
+        WorkStealingQueue<std::size_t, 64> queue;
+        std::vector<std::atomic<std::uint32_t>> taken(Values);
+        std::atomic_bool done = false;
+
+        std::vector<std::thread> thieves;
+        for (std::size_t i = 0; i < Thieves; ++i) {
+            thieves.emplace_back([&] {
+                std::size_t value = 0;
+                while (!done.load()) {
+                    if (queue.steal(value)) taken[value].fetch_add(1);
+                }
+            });
+        }
+
+        std::mt19937 random{ 1 };
+        std::size_t value = 0;
+        for (std::size_t next = 0; next < Values;) {
+            // Push a few, then pop a few, so the owner often races for the last element
+            const std::size_t pushes = random() % 8;
+            for (std::size_t i = 0; i < pushes && next < Values; ++i) {
+                if (!queue.push(next)) break;
+                ++next;
+            }
+
+            const std::size_t pops = random() % 8;
+            for (std::size_t i = 0; i < pops; ++i) {
+                if (queue.pop(value)) taken[value].fetch_add(1);
+            }
+        }
+
+        while (queue.pop(value)) taken[value].fetch_add(1);
+        while (!queue.empty()) std::this_thread::yield(); // Thieves finish what they claimed
+
+        done = true;
+        for (auto& thief : thieves) thief.join();
+
+        for (std::size_t i = 0; i < Values; ++i) {
+            ASSERT_EQ(taken[i].load(), 1) << "value " << i;
+        }
+    }
+
+    // ------------------------------------------------
+
+    // Workers park after a handful of failed steals, so every round has to wake them up again.
+    TEST(WorkerPoolTests, EveryJobRunsOnceWithParkingWorkers) {
+        constexpr std::size_t Rounds = 2000;
+        constexpr std::size_t Jobs = 32;
+
+        WorkerPool pool{ { .workers = 3, .spinIterations = 16 } };
+        JobGroup group;
+        ASSERT_TRUE(pool.add(group));
+
+        std::vector<std::atomic<std::uint32_t>> runs(Rounds * Jobs);
+        auto job = [](void* context, std::size_t index) {
+            static_cast<std::atomic<std::uint32_t>*>(context)[index].fetch_add(1);
+        };
+
+        for (std::size_t round = 0; round < Rounds; ++round) {
+            for (std::size_t i = 0; i < Jobs; ++i) {
+                ASSERT_TRUE(group.add(Job{ job, runs.data(), round * Jobs + i }));
+            }
+
+            pool.execute(group);
+            ASSERT_TRUE(group.done());
+
+            // Give the workers time to park every now and then
+            if (round % 100 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        pool.remove(group);
+
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            ASSERT_EQ(runs[i].load(), 1) << "job " << i;
+        }
+    }
+
+    TEST(WorkerPoolTests, GroupsSharingThePoolRunEveryJobOnce) {
+        constexpr std::size_t Rounds = 2000;
+        constexpr std::size_t Jobs = 16;
+        constexpr std::size_t Groups = 2;
+
+        WorkerPool pool{ { .workers = 2, .spinIterations = 64 } };
+        std::vector<std::atomic<std::uint32_t>> runs(Groups * Rounds * Jobs);
+        auto job = [](void* context, std::size_t index) {
+            static_cast<std::atomic<std::uint32_t>*>(context)[index].fetch_add(1);
+        };
+
+        // Every group is submitted from its own thread, like separate plugin instances
+        std::vector<std::thread> submitters;
+        for (std::size_t g = 0; g < Groups; ++g) {
+            submitters.emplace_back([&, g] {
+                JobGroup group;
+                pool.add(group);
+                for (std::size_t round = 0; round < Rounds; ++round) {
+                    for (std::size_t i = 0; i < Jobs; ++i) {
+                        group.add(Job{ job, runs.data(), (g * Rounds + round) * Jobs + i });
+                    }
+                    pool.execute(group);
+                }
+                pool.remove(group);
+            });
+        }
+
+        for (auto& submitter : submitters) submitter.join();
+
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            ASSERT_EQ(runs[i].load(), 1) << "job " << i;
+        }
+    }
+
+    // ------------------------------------------------
+
+}